@@ -4,6 +4,7 @@
 // Copyright 2016 whitequark
 //-----------------------------------------------------------------------------
 #include "solvespace.h"
+#include "mimalloc.h"
 
 static bool RunBenchmark(std::function<void()> setupFn,
                          std::function<bool()> benchFn,
@@ -20,13 +21,20 @@ static bool RunBenchmark(std::function<void()> setupFn,
     // Benchmark
     size_t iter = 0;
     double time = 0.0;
+    size_t tempAllocs = 0, tempBytes = 0, tempPeakBytes = 0;
     while(iter < minIter || time < minTime) {
         setupFn();
+        Platform::TemporaryStatsScope tempStats;
         auto testStartTime = std::chrono::steady_clock::now();
         benchFn();
         auto testEndTime = std::chrono::steady_clock::now();
+        Platform::TemporaryStats stats = tempStats.Get();
         teardownFn();
 
+        tempAllocs   += stats.totalAllocations;
+        tempBytes    += stats.totalBytes;
+        tempPeakBytes = std::max(tempPeakBytes, stats.peakBytes);
+
         std::chrono::duration<double> testTime = testEndTime - testStartTime;
         time += testTime.count();
         iter += 1;
@@ -36,10 +44,35 @@ static bool RunBenchmark(std::function<void()> setupFn,
     fprintf(stdout, "Iterations: %zd\n", iter);
     fprintf(stdout, "Time:       %.3f s\n", time);
     fprintf(stdout, "Per iter.:  %.3f s\n", time / (double)iter);
+    fprintf(stdout, "Temp alloc: %zu per iter., %zu KiB per iter.\n",
+            tempAllocs / iter, tempBytes / iter / 1024);
+    fprintf(stdout, "Temp peak:  %zu KiB\n", tempPeakBytes / 1024);
 
     return true;
 }
 
+// Allocates as many nodes as a large solve would, and initializes them the
+// way Expr::AnyOp does; the memory is released outside of the timed part.
+template<class AllocFn>
+static bool RunAllocBenchmark(const char *name, AllocFn allocFn,
+                              std::function<void()> freeFn) {
+    fprintf(stdout, "%s:\n", name);
+    return RunBenchmark(
+        [] {},
+        [&] {
+            Expr *prev = NULL;
+            for(size_t i = 0; i < 1000000; i++) {
+                Expr *e = (Expr *)allocFn(sizeof(Expr));
+                e->op = Expr::Op::PLUS;
+                e->a  = prev;
+                e->b  = prev;
+                prev = e;
+            }
+            return prev != NULL;
+        },
+        freeFn, /*minIter=*/5, /*minTime=*/1.0);
+}
+
 int main(int argc, char **argv) {
     std::vector<std::string> args = Platform::InitCli(argc, argv);
 
@@ -48,9 +81,11 @@ int main(int argc, char **argv) {
     if(args.size() == 3) {
         mode = args[1];
         filename = Platform::Path::From(args[2]);
+    } else if(args.size() == 2 && args[1] == "alloc") {
+        mode = args[1];
     } else {
         fprintf(stderr, "Usage: %s [mode] [filename]\n", args[0].c_str());
-        fprintf(stderr, "Mode can be one of: load.\n");
+        fprintf(stderr, "Mode can be one of: load, alloc (without a filename).\n");
         return 1;
     }
 
@@ -70,6 +105,22 @@ int main(int argc, char **argv) {
                 SK.Clear();
                 SS.Clear();
             });
+    } else if(mode == "alloc") {
+        mi_heap_t *heap = mi_heap_new();
+        result = RunAllocBenchmark("mi_heap_zalloc",
+            [&](size_t size) { return mi_heap_zalloc(heap, size); },
+            [&] {
+                mi_heap_destroy(heap);
+                heap = mi_heap_new();
+            });
+        mi_heap_destroy(heap);
+
+        result = result && RunAllocBenchmark("AllocTemporary",
+            [](size_t size) { return AllocTemporary(size); },
+            [] { FreeAllTemporary(); });
+        result = result && RunAllocBenchmark("AllocTemporaryUninitialized",
+            [](size_t size) { return AllocTemporaryUninitialized(size); },
+            [] { FreeAllTemporary(); });
     } else {
         fprintf(stderr, "Unknown mode \"%s\"\n", mode.c_str());
     }
@@ -190,6 +190,18 @@ typedef struct {
 #define SLVS_RESULT_DIDNT_CONVERGE      2
 #define SLVS_RESULT_TOO_MANY_UNKNOWNS   3
     int                 result;
+
+    /*** INPUT VARIABLES, continued
+     *
+     * The method used to solve the nonlinear system. Newton's method is the
+     * default. Levenberg-Marquardt takes damped steps that always reduce the
+     * error, so it is more likely to converge when a point is dragged far
+     * to a position that the constraints allow; but when they don't, it may
+     * stop where the error is least, while Newton's method may jump to some
+     * other solution. */
+#define SLVS_SOLVE_NEWTON               0
+#define SLVS_SOLVE_LEVENBERG_MARQUARDT  1
+    int                 algorithm;
 } Slvs_System;
 
 DLL void Slvs_Solve(Slvs_System *sys, Slvs_hGroup hg);
@@ -9,41 +9,41 @@
 void SolveSpaceUI::Clipboard::Clear() {
     c.Clear();
     r.Clear();
+    entitySlots.clear();
+    requestsIndexed = 0;
+}
+
+void SolveSpaceUI::Clipboard::IndexRequests() {
+    for(; requestsIndexed < r.n; requestsIndexed++) {
+        const ClipboardRequest &cr = r[requestsIndexed];
+        // If an entity appears more than once, then the first appearance
+        // wins, same as if we searched the list.
+        entitySlots.emplace(cr.oldEnt.v, EntitySlot { requestsIndexed, 0 });
+        for(int i = 0; i < MAX_POINTS_IN_ENTITY; i++) {
+            if(cr.oldPointEnt[i] == Entity::NO_ENTITY) continue;
+            entitySlots.emplace(cr.oldPointEnt[i].v,
+                                EntitySlot { requestsIndexed, 1+i });
+        }
+    }
 }
 
 bool SolveSpaceUI::Clipboard::ContainsEntity(hEntity he) {
     if(he == Entity::NO_ENTITY)
         return true;
 
-    ClipboardRequest *cr;
-    for(cr = r.First(); cr; cr = r.NextAfter(cr)) {
-        if(cr->oldEnt == he)
-            return true;
-
-        for(int i = 0; i < MAX_POINTS_IN_ENTITY; i++) {
-            if(cr->oldPointEnt[i] == he)
-                return true;
-        }
-    }
-    return false;
+    IndexRequests();
+    return entitySlots.find(he.v) != entitySlots.end();
 }
 
 hEntity SolveSpaceUI::Clipboard::NewEntityFor(hEntity he) {
     if(he == Entity::NO_ENTITY)
         return Entity::NO_ENTITY;
 
-    ClipboardRequest *cr;
-    for(cr = r.First(); cr; cr = r.NextAfter(cr)) {
-        if(cr->oldEnt == he)
-            return cr->newReq.entity(0);
-
-        for(int i = 0; i < MAX_POINTS_IN_ENTITY; i++) {
-            if(cr->oldPointEnt[i] == he)
-                return cr->newReq.entity(1+i);
-        }
-    }
-
-    ssassert(false, "Expected to find entity in some clipboard request");
+    IndexRequests();
+    auto it = entitySlots.find(he.v);
+    ssassert(it != entitySlots.end(),
+             "Expected to find entity in some clipboard request");
+    return r[it->second.request].newReq.entity(it->second.slot);
 }
 
 void GraphicsWindow::DeleteSelection() {
@@ -179,20 +179,36 @@ void GraphicsWindow::PasteClipboard(Vector trans, double theta, double scale) {
         return he;
     };
 
+    // Add all of the requests first. They're created with the right number
+    // of points from the start, so we can generate their entities and
+    // parameters directly, and add those to the sketch in one pass, instead
+    // of regenerating everything after each request.
+    IdList<Entity,hEntity> entities = {};
+    IdList<Param,hParam>   params   = {};
     ClipboardRequest *cr;
     for(cr = SS.clipboard.r.First(); cr; cr = SS.clipboard.r.NextAfter(cr)) {
-        hRequest hr = AddRequest(cr->type, /*rememberForUndo=*/false);
+        Request r = {};
+        r.group        = activeGroup;
+        r.workplane    = ActiveWorkplane();
+        r.type         = cr->type;
+        r.extraPoints  = cr->extraPoints;
+        r.style        = cr->style;
+        r.str          = cr->str;
+        r.font         = cr->font;
+        r.file         = cr->file;
+        r.construction = cr->construction;
+        cr->newReq = SK.request.AddAndAssignId(&r);
+        SK.GetRequest(cr->newReq)->Generate(&entities, &params);
+    }
+    SK.entity.MergeFrom(&entities);
+    SK.param.MergeFrom(&params);
+    if(!SS.clipboard.r.IsEmpty()) {
+        SS.MarkGroupDirty(activeGroup);
+    }
+
+    for(cr = SS.clipboard.r.First(); cr; cr = SS.clipboard.r.NextAfter(cr)) {
+        hRequest hr = cr->newReq;
         Request *r = SK.GetRequest(hr);
-        r->extraPoints  = cr->extraPoints;
-        r->style        = cr->style;
-        r->str          = cr->str;
-        r->font         = cr->font;
-        r->file         = cr->file;
-        r->construction = cr->construction;
-        // Need to regen to get the right number of points, if extraPoints
-        // changed.
-        SS.GenerateAll(SolveSpaceUI::Generate::REGEN);
-        SS.MarkGroupDirty(r->group);
         bool hasDistance;
         int i, pts;
         EntReqTable::GetRequestInfo(r->type, r->extraPoints,
@@ -219,13 +235,14 @@ void GraphicsWindow::PasteClipboard(Vector trans, double theta, double scale) {
                                             cr->distance*fabs(scale));
         }
 
-        cr->newReq = hr;
         MakeSelected(hr.entity(0));
         for(i = 0; i < pts; i++) {
             int j = (r->type == Request::Type::DATUM_POINT) ? i : i + 1;
             MakeSelected(hr.entity(j));
         }
     }
+    // Likewise for the constraints, which are all added at the end.
+    std::vector<Constraint> constraints;
     Constraint *cc;
     for(cc = SS.clipboard.c.First(); cc; cc = SS.clipboard.c.NextAfter(cc)) {
         Constraint c = {};
@@ -296,10 +313,13 @@ void GraphicsWindow::PasteClipboard(Vector trans, double theta, double scale) {
                 break;
         }
         if (!dontAddConstraint) {
-            hConstraint hc = Constraint::AddConstraint(&c, /*rememberForUndo=*/false);
-            if(c.type == Constraint::Type::COMMENT) {
-                MakeSelected(hc);
-            }
+            constraints.push_back(c);
+        }
+    }
+    Constraint::AddConstraints(&constraints);
+    for(const Constraint &c : constraints) {
+        if(c.type == Constraint::Type::COMMENT) {
+            MakeSelected(c.h);
         }
     }
 }
@@ -212,6 +212,15 @@ void TextWindow::ScreenChangeFindConstraintTimeout(int link, uint32_t v) {
     SS.TW.edit.meaning = Edit::FIND_CONSTRAINT_TIMEOUT;
 }
 
+void TextWindow::ScreenChangeSolverAlgorithm(int link, uint32_t v) {
+    if(link == 'l') {
+        SS.solverAlgorithm = System::Algorithm::LEVENBERG_MARQUARDT;
+    } else {
+        SS.solverAlgorithm = System::Algorithm::NEWTON;
+    }
+    SS.GenerateAll(SolveSpaceUI::Generate::ALL);
+}
+
 void TextWindow::ShowConfiguration() {
     int i;
     Printf(true, "%Ft user color (r, g, b)");
@@ -381,6 +390,14 @@ void TextWindow::ShowConfiguration() {
     Printf(false, "%Ft redundant constraint timeout (in ms)%E");
     Printf(false, "%Ba   %d %Fl%Ll%f[change]%E",
         SS.timeoutRedundantConstr, &ScreenChangeFindConstraintTimeout);
+    Printf(false, "");
+    Printf(false, "%Ft solver:  "
+                  "%f%Fd%Ln%s Newton%E  "
+                  "%f%Fd%Ll%s Levenberg-Marquardt%E",
+        &ScreenChangeSolverAlgorithm,
+        SS.solverAlgorithm == System::Algorithm::NEWTON ? RADIO_TRUE : RADIO_FALSE,
+        &ScreenChangeSolverAlgorithm,
+        SS.solverAlgorithm == System::Algorithm::LEVENBERG_MARQUARDT ? RADIO_TRUE : RADIO_FALSE);
 
     if(canvas) {
         const char *gl_vendor, *gl_renderer, *gl_version;
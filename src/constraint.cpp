@@ -86,6 +86,25 @@ hConstraint Constraint::AddConstraint(Constraint *c, bool rememberForUndo) {
     return c->h;
 }
 
+// Add many constraints at once, assigning their handles in order; like
+// AddConstraint, but the new parameters go into the sketch in one pass, and
+// each group gets marked dirty just once.
+void Constraint::AddConstraints(std::vector<Constraint> *cs) {
+    IdList<Param,hParam> params = {};
+    std::set<hGroup> groups;
+    for(Constraint &c : *cs) {
+        hConstraint hc = SK.constraint.AddAndAssignId(&c);
+        SK.GetConstraint(hc)->Generate(&params);
+        groups.insert(c.group);
+    }
+    SK.param.MergeFrom(&params);
+
+    for(hGroup hg : groups) {
+        SS.MarkGroupDirty(hg);
+        SK.GetGroup(hg)->dofCheckOk = false;
+    }
+}
+
 hConstraint Constraint::Constrain(Constraint::Type type, hEntity ptA, hEntity ptB,
                                   hEntity entityA, hEntity entityB,
                                   bool other, bool other2)
@@ -424,23 +424,32 @@ void GraphicsWindow::HitTestMakeSelection(Point2d mp) {
 
     // Always do the entities; we might be dragging something that should
     // be auto-constrained, and we need the hover for that.
-    for(Entity &e : SK.entity) {
-        if(!e.IsVisible()) continue;
+    auto hoverEntity = [&](Entity &e) {
+        if(!e.IsVisible()) return;
 
         // If faces aren't selectable, image entities aren't either.
-        if(e.type == Entity::Type::IMAGE && !showFaces) continue;
+        if(e.type == Entity::Type::IMAGE && !showFaces) return;
 
         // Don't hover whatever's being dragged.
         if(IsFromPending(e.h.request())) {
             // The one exception is when we're creating a new cubic; we
             // want to be able to hover the first point, because that's
             // how we turn it into a periodic spline.
-            if(!e.IsPoint()) continue;
-            if(!e.h.isFromRequest()) continue;
+            if(!e.IsPoint()) return;
+            if(!e.h.isFromRequest()) return;
             Request *r = SK.GetRequest(e.h.request());
-            if(r->type != Request::Type::CUBIC) continue;
-            if(r->extraPoints < 2) continue;
-            if(e.h.v != r->h.entity(1).v) continue;
+            if(r->type != Request::Type::CUBIC) return;
+            if(r->extraPoints < 2) return;
+            if(e.h.v != r->h.entity(1).v) return;
+        }
+
+        // Curves can't be hovered from outside their screen bounding box
+        // (plus a margin for the line width), so skip drawing those.
+        if(!e.IsPoint() && !e.IsNormal()) {
+            bool hasBBox;
+            BBox box = e.GetOrGenerateScreenBBox(&hasBBox);
+            double margin = 2 * canvas.selRadius + Style::Width(Style::ForEntity(e.h));
+            if(hasBBox && !box.Contains(mp, margin)) return;
         }
 
         if(canvas.Pick([&]{ e.Draw(Entity::DrawAs::DEFAULT, &canvas); })) {
@@ -451,6 +460,43 @@ void GraphicsWindow::HitTestMakeSelection(Point2d mp) {
             hov.selection.entity = e.h;
             hoverList.Add(&hov);
         }
+    };
+    for(Entity &e : SK.entity) {
+        if(e.IsPoint()) continue;
+        hoverEntity(e);
+    }
+
+    // Points are most of the entities in a large sketch, so only try the
+    // ones that the index finds near the mouse. A box of model space can
+    // hold such a point if its projected corners are near the mouse, with a
+    // margin for the largest point that's drawn; unless it's partly behind
+    // the camera.
+    double pointMargin = 2 * canvas.selRadius + 14.0;
+    auto nearMouse = [&](const BBox &b) {
+        BBox screen = {};
+        for(int i = 0; i < 8; i++) {
+            Vector c = Vector::From((i & 1) ? b.maxp.x : b.minp.x,
+                                    (i & 2) ? b.maxp.y : b.minp.y,
+                                    (i & 4) ? b.maxp.z : b.minp.z);
+            double w;
+            Vector pp = ProjectPoint4(c, &w);
+            if(w <= 0) return true;
+            pp = pp.ScaledBy(scale/w);
+            if(i == 0) {
+                screen = BBox::From(pp, pp);
+            } else {
+                screen.Include(pp);
+            }
+        }
+        return screen.Contains(mp, pointMargin);
+    };
+    std::vector<hEntity> points;
+    for(hGroup hg : SK.groupOrder) {
+        SK.pointIndex.FindPoints(hg, nearMouse, &points);
+        for(hEntity he : points) {
+            Entity *e = SK.entity.FindByIdNoOops(he);
+            if(e != NULL) hoverEntity(*e);
+        }
     }
 
     // The constraints and faces happen only when nothing's in progress.
@@ -521,6 +521,33 @@ public:
         ++n;
     }
 
+    // Move all of the elements of l into this list, leaving l empty. None
+    // of them may have the same handle as one of ours. This is the same as
+    // calling Add() for each, but takes linear time overall.
+    void MergeFrom(IdList<T,H> *l) {
+        if(l->IsEmpty()) return;
+
+        size_t oldn = elemidx.size();
+        ReserveMore(l->n);
+        for(int i : l->elemidx) {
+            elemstore.push_back(std::move(l->elemstore[i]));
+            elemidx.push_back((int)elemstore.size() - 1);
+        }
+        n += l->n;
+
+        std::inplace_merge(elemidx.begin(), elemidx.begin() + oldn, elemidx.end(),
+            [&](int a, int b) { return elemstore[a].h.v < elemstore[b].h.v; });
+        for(size_t i = 1; i < elemidx.size(); i++) {
+            ssassert(elemstore[elemidx[i - 1]].h.v != elemstore[elemidx[i]].h.v,
+                     "Handle isn't unique");
+        }
+
+        l->freelist.clear();
+        l->elemidx.clear();
+        l->elemstore.clear();
+        l->n = 0;
+    }
+
     T *FindById(H h) {
         T *t = FindByIdNoOops(h);
         ssassert(t != nullptr, "Cannot find handle");
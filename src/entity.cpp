@@ -284,12 +284,15 @@ Quaternion EntityBase::NormalGetNum() const {
             break;
 
         case Type::NORMAL_N_ROT:
-            q = Quaternion::From(param[0], param[1], param[2], param[3]);
-            q = q.Times(numNormal);
-            break;
-
         case Type::NORMAL_N_ROT_AA: {
-            q = GetAxisAngleQuaternion(0);
+            const Group::CopyTransform *ct = GetCopyTransform(param[0], 3);
+            if(ct != NULL) {
+                q = ct->q;
+            } else if(type == Type::NORMAL_N_ROT) {
+                q = Quaternion::From(param[0], param[1], param[2], param[3]);
+            } else {
+                q = GetAxisAngleQuaternion(0);
+            }
             q = q.Times(numNormal);
             break;
         }
@@ -300,6 +303,8 @@ Quaternion EntityBase::NormalGetNum() const {
 }
 
 void EntityBase::NormalForceTo(Quaternion q) {
+    InvalidateCopyTransforms();
+
     switch(type) {
         case Type::NORMAL_IN_3D:
             SK.GetParam(param[0])->val = q.w;
@@ -405,6 +410,8 @@ void EntityBase::PointForceParamTo(Vector p) {
 }
 
 void EntityBase::PointForceTo(Vector p) {
+    InvalidateCopyTransforms();
+
     switch(type) {
         case Type::POINT_IN_3D:
             SK.GetParam(param[0])->val = p.x;
@@ -493,6 +500,10 @@ void EntityBase::PointForceTo(Vector p) {
 
         default: ssassert(false, "Unexpected entity type");
     }
+
+#ifndef LIBRARY
+    SK.pointIndex.PointMoved(group, h, PointGetNum());
+#endif
 }
 
 Vector EntityBase::PointGetNum() const {
@@ -513,22 +524,29 @@ Vector EntityBase::PointGetNum() const {
         }
 
         case Type::POINT_N_TRANS: {
+            const Group::CopyTransform *ct = GetCopyTransform(param[0], 0);
+            if(ct != NULL) {
+                p = numPoint.Plus(ct->displace);
+                break;
+            }
             Vector trans = Vector::From(param[0], param[1], param[2]);
             p = numPoint.Plus(trans.ScaledBy(timesApplied));
             break;
         }
 
         case Type::POINT_N_ROT_TRANS: {
-            Vector offset = Vector::From(param[0], param[1], param[2]);
-            Quaternion q = PointGetQuaternion();
+            const Group::CopyTransform *ct = GetCopyTransform(param[3], 3);
+            Vector offset = ct ? ct->offset : Vector::From(param[0], param[1], param[2]);
+            Quaternion q = ct ? ct->q : PointGetQuaternion();
             p = q.Rotate(numPoint);
             p = p.Plus(offset);
             break;
         }
 
         case Type::POINT_N_ROT_AA: {
-            Vector offset = Vector::From(param[0], param[1], param[2]);
-            Quaternion q = PointGetQuaternion();
+            const Group::CopyTransform *ct = GetCopyTransform(param[3], 3);
+            Vector offset = ct ? ct->offset : Vector::From(param[0], param[1], param[2]);
+            Quaternion q = ct ? ct->q : PointGetQuaternion();
             p = numPoint.Minus(offset);
             p = q.Rotate(p);
             p = p.Plus(offset);
@@ -651,6 +669,7 @@ ExprVector EntityBase::PointGetExprsInWorkplane(hEntity wrkpl) const {
 
 void EntityBase::PointForceQuaternionTo(Quaternion q) {
     ssassert(type == Type::POINT_N_ROT_TRANS, "Unexpected entity type");
+    InvalidateCopyTransforms();
 
     SK.GetParam(param[3])->val = q.w;
     SK.GetParam(param[4])->val = q.vx;
@@ -669,6 +688,28 @@ Quaternion EntityBase::GetAxisAngleQuaternion(int param0) const {
     return q;
 }
 
+//-----------------------------------------------------------------------------
+// Find the cached transform of the group that copied this entity, if the
+// entity takes its transform from that group's params; hp is the entity's
+// param that must be the group's param with index groupParam.
+//-----------------------------------------------------------------------------
+const Group::CopyTransform *EntityBase::GetCopyTransform(hParam hp, int groupParam) const {
+#ifdef LIBRARY
+    // The library doesn't make copies, and doesn't have their groups.
+    return NULL;
+#else
+    Group *g = SK.group.FindByIdNoOops(group);
+    if(g == NULL) return NULL;
+    if(hp != g->h.param(groupParam)) return NULL;
+    return g->GetCopyTransform(timesApplied);
+#endif
+}
+
+void EntityBase::InvalidateCopyTransforms() const {
+    Group *g = SK.group.FindByIdNoOops(group);
+    if(g != NULL) g->InvalidateCopyTransforms();
+}
+
 ExprQuaternion EntityBase::GetAxisAngleQuaternionExprs(int param0) const {
     ExprQuaternion q;
 
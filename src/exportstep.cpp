@@ -6,7 +6,7 @@
 #include "solvespace.h"
 
 void StepFileWriter::WriteHeader() {
-    fprintf(f,
+    Write(
 "ISO-10303-21;\n"
 "HEADER;\n"
 "\n"
@@ -67,7 +67,7 @@ void StepFileWriter::WriteHeader() {
     id = 200;
 }
 void StepFileWriter::WriteProductHeader() {
-	fprintf(f,
+	Write(
 		"#175 = SHAPE_DEFINITION_REPRESENTATION(#176, #169);\n"
 		"#176 = PRODUCT_DEFINITION_SHAPE('Version', 'Test Part', #177);\n"
 		"#177 = PRODUCT_DEFINITION('Version', 'Test Part', #182, #178);\n"
@@ -81,36 +81,70 @@ void StepFileWriter::WriteProductHeader() {
 		"\n"
 		);
 }
+//-----------------------------------------------------------------------------
+// Output is accumulated in a buffer and written out in large pieces, rather
+// than through many small fprintf calls. A writer with no file just keeps
+// its buffer, to be concatenated with others later.
+//-----------------------------------------------------------------------------
+void StepFileWriter::Write(const char *fmt, ...) {
+    va_list va;
+    va_start(va, fmt);
+    vssappendf(&buf, fmt, va);
+    va_end(va);
+
+    if(f && buf.size() > (1 << 16)) Flush();
+}
+
+void StepFileWriter::Flush() {
+    if(f && !buf.empty()) {
+        fwrite(buf.data(), 1, buf.size(), f);
+        buf.clear();
+    }
+}
+
+// Exactly as %.10f, but faster.
+void StepFileWriter::WriteNumber(double v) {
+    AppendFixed(&buf, v, 10);
+}
+
+void StepFileWriter::WritePoint(int pid, Vector p) {
+    Write("#%d=CARTESIAN_POINT('',(", pid);
+    WriteNumber(p.x);
+    buf += ',';
+    WriteNumber(p.y);
+    buf += ',';
+    WriteNumber(p.z);
+    buf += "));\n";
+}
+
 int StepFileWriter::ExportCurve(SBezier *sb) {
     int i, ret = id;
 
-    fprintf(f, "#%d=(\n", ret);
-    fprintf(f, "BOUNDED_CURVE()\n");
-    fprintf(f, "B_SPLINE_CURVE(%d,(", sb->deg);
+    Write("#%d=(\n", ret);
+    Write("BOUNDED_CURVE()\n");
+    Write("B_SPLINE_CURVE(%d,(", sb->deg);
     for(i = 0; i <= sb->deg; i++) {
-        fprintf(f, "#%d", ret + i + 1);
-        if(i != sb->deg) fprintf(f, ",");
+        Write("#%d", ret + i + 1);
+        if(i != sb->deg) Write(",");
     }
-    fprintf(f, "),.UNSPECIFIED.,.F.,.F.)\n");
-    fprintf(f, "B_SPLINE_CURVE_WITH_KNOTS((%d,%d),",
+    Write("),.UNSPECIFIED.,.F.,.F.)\n");
+    Write("B_SPLINE_CURVE_WITH_KNOTS((%d,%d),",
         (sb->deg + 1), (sb-> deg + 1));
-    fprintf(f, "(0.000,1.000),.UNSPECIFIED.)\n");
-    fprintf(f, "CURVE()\n");
-    fprintf(f, "GEOMETRIC_REPRESENTATION_ITEM()\n");
-    fprintf(f, "RATIONAL_B_SPLINE_CURVE((");
+    Write("(0.000,1.000),.UNSPECIFIED.)\n");
+    Write("CURVE()\n");
+    Write("GEOMETRIC_REPRESENTATION_ITEM()\n");
+    Write("RATIONAL_B_SPLINE_CURVE((");
     for(i = 0; i <= sb->deg; i++) {
-        fprintf(f, "%.10f", sb->weight[i]);
-        if(i != sb->deg) fprintf(f, ",");
+        WriteNumber(sb->weight[i]);
+        if(i != sb->deg) Write(",");
     }
-    fprintf(f, "))\n");
-    fprintf(f, "REPRESENTATION_ITEM('')\n);\n");
+    Write("))\n");
+    Write("REPRESENTATION_ITEM('')\n);\n");
 
     for(i = 0; i <= sb->deg; i++) {
-        fprintf(f, "#%d=CARTESIAN_POINT('',(%.10f,%.10f,%.10f));\n",
-            id + 1 + i,
-            CO(sb->ctrl[i]));
+        WritePoint(id + 1 + i, sb->ctrl[i]);
     }
-    fprintf(f, "\n");
+    Write("\n");
 
     id = ret + 1 + (sb->deg + 1);
     return ret;
@@ -126,9 +160,8 @@ int StepFileWriter::ExportCurveLoop(SBezierLoop *loop, bool inner) {
     // Generate "exactly closed" contours, with the same vertex id for the
     // finish of a previous edge and the start of the next one. So we need
     // the finish of the last Bezier in the loop before we start our process.
-    fprintf(f, "#%d=CARTESIAN_POINT('',(%.10f,%.10f,%.10f));\n",
-        id, CO(sb->Finish()));
-    fprintf(f, "#%d=VERTEX_POINT('',#%d);\n", id+1, id);
+    WritePoint(id, sb->Finish());
+    Write("#%d=VERTEX_POINT('',#%d);\n", id+1, id);
     int lastFinish = id + 1, prevFinish = lastFinish;
     id += 2;
 
@@ -137,18 +170,17 @@ int StepFileWriter::ExportCurveLoop(SBezierLoop *loop, bool inner) {
 
         int thisFinish;
         if(loop->l.NextAfter(sb) != NULL) {
-            fprintf(f, "#%d=CARTESIAN_POINT('',(%.10f,%.10f,%.10f));\n",
-                id, CO(sb->Finish()));
-            fprintf(f, "#%d=VERTEX_POINT('',#%d);\n", id+1, id);
+            WritePoint(id, sb->Finish());
+            Write("#%d=VERTEX_POINT('',#%d);\n", id+1, id);
             thisFinish = id + 1;
             id += 2;
         } else {
             thisFinish = lastFinish;
         }
 
-        fprintf(f, "#%d=EDGE_CURVE('',#%d,#%d,#%d,%s);\n",
+        Write("#%d=EDGE_CURVE('',#%d,#%d,#%d,%s);\n",
             id, prevFinish, thisFinish, curveId, ".T.");
-        fprintf(f, "#%d=ORIENTED_EDGE('',*,*,#%d,.T.);\n",
+        Write("#%d=ORIENTED_EDGE('',*,*,#%d,.T.);\n",
             id+1, id);
 
         int oe = id+1;
@@ -158,16 +190,16 @@ int StepFileWriter::ExportCurveLoop(SBezierLoop *loop, bool inner) {
         prevFinish = thisFinish;
     }
 
-    fprintf(f, "#%d=EDGE_LOOP('',(", id);
+    Write("#%d=EDGE_LOOP('',(", id);
     int *oe;
     for(oe = listOfTrims.First(); oe; oe = listOfTrims.NextAfter(oe)) {
-        fprintf(f, "#%d", *oe);
-        if(listOfTrims.NextAfter(oe) != NULL) fprintf(f, ",");
+        Write("#%d", *oe);
+        if(listOfTrims.NextAfter(oe) != NULL) Write(",");
     }
-    fprintf(f, "));\n");
+    Write("));\n");
 
     int fb = id + 1;
-        fprintf(f, "#%d=%s('',#%d,.T.);\n",
+        Write("#%d=%s('',#%d,.T.);\n",
             fb, inner ? "FACE_BOUND" : "FACE_OUTER_BOUND", id);
 
     id += 2;
@@ -176,77 +208,98 @@ int StepFileWriter::ExportCurveLoop(SBezierLoop *loop, bool inner) {
     return fb;
 }
 
-void StepFileWriter::ExportSurface(SSurface *ss, SBezierList *sbl) {
+// Group the trim curves of a surface into outer loops, each along with its
+// inner loops.
+void StepFileWriter::FindTrimLoops(SSurface *ss, SBezierList *sbl,
+                                   SBezierLoopSetSet *sblss)
+{
+    SPolygon spxyz = {};
+    bool allClosed;
+    SEdge notClosedAt;
+    // We specify a surface, so it doesn't check for coplanarity; and we
+    // don't want it to give us any open contours. The polygon and chord
+    // tolerance are required, because they are used to calculate the
+    // contour directions and determine inner vs. outer contours.
+    sblss->FindOuterFacesFrom(sbl, &spxyz, ss,
+                              SS.ExportChordTolMm(),
+                              &allClosed, &notClosedAt,
+                              NULL, NULL,
+                              NULL);
+    spxyz.Clear();
+}
+
+// The number of entity IDs that ExportSurface will use for this surface and
+// these trim loops, so that the IDs can be handed out before we write it.
+int StepFileWriter::IdsForSurface(SSurface *ss, SBezierLoopSetSet *sblss) {
+    int n = 1 + (ss->degm + 1)*(ss->degn + 1);
+    for(SBezierLoopSet &sbls : sblss->l) {
+        for(SBezierLoop &loop : sbls.l) {
+            n += 2;
+            for(int i = 0; i < loop.l.n; i++) {
+                n += (loop.l[i].deg + 2) + 2;
+                if(i != loop.l.n - 1) n += 2;
+            }
+            n += 2;
+        }
+        // The advanced face, and its style.
+        n += 11;
+    }
+    return n;
+}
+
+void StepFileWriter::ExportSurface(SSurface *ss, SBezierLoopSetSet *sblss) {
     int i, j, srfid = id;
 
     // First, we create the untrimmed surface. We always specify a rational
     // B-spline surface (in fact, just a Bezier surface).
-    fprintf(f, "#%d=(\n", srfid);
-    fprintf(f, "BOUNDED_SURFACE()\n");
-    fprintf(f, "B_SPLINE_SURFACE(%d,%d,(", ss->degm, ss->degn);
+    Write("#%d=(\n", srfid);
+    Write("BOUNDED_SURFACE()\n");
+    Write("B_SPLINE_SURFACE(%d,%d,(", ss->degm, ss->degn);
     for(i = 0; i <= ss->degm; i++) {
-        fprintf(f, "(");
+        Write("(");
         for(j = 0; j <= ss->degn; j++) {
-            fprintf(f, "#%d", srfid + 1 + j + i*(ss->degn + 1));
-            if(j != ss->degn) fprintf(f, ",");
+            Write("#%d", srfid + 1 + j + i*(ss->degn + 1));
+            if(j != ss->degn) Write(",");
         }
-        fprintf(f, ")");
-        if(i != ss->degm) fprintf(f, ",");
+        Write(")");
+        if(i != ss->degm) Write(",");
     }
-    fprintf(f, "),.UNSPECIFIED.,.F.,.F.,.F.)\n");
-    fprintf(f, "B_SPLINE_SURFACE_WITH_KNOTS((%d,%d),(%d,%d),",
+    Write("),.UNSPECIFIED.,.F.,.F.,.F.)\n");
+    Write("B_SPLINE_SURFACE_WITH_KNOTS((%d,%d),(%d,%d),",
         (ss->degm + 1), (ss->degm + 1),
         (ss->degn + 1), (ss->degn + 1));
-    fprintf(f, "(0.000,1.000),(0.000,1.000),.UNSPECIFIED.)\n");
-    fprintf(f, "GEOMETRIC_REPRESENTATION_ITEM()\n");
-    fprintf(f, "RATIONAL_B_SPLINE_SURFACE((");
+    Write("(0.000,1.000),(0.000,1.000),.UNSPECIFIED.)\n");
+    Write("GEOMETRIC_REPRESENTATION_ITEM()\n");
+    Write("RATIONAL_B_SPLINE_SURFACE((");
     for(i = 0; i <= ss->degm; i++) {
-        fprintf(f, "(");
+        Write("(");
         for(j = 0; j <= ss->degn; j++) {
-            fprintf(f, "%.10f", ss->weight[i][j]);
-            if(j != ss->degn) fprintf(f, ",");
+            WriteNumber(ss->weight[i][j]);
+            if(j != ss->degn) Write(",");
         }
-        fprintf(f, ")");
-        if(i != ss->degm) fprintf(f, ",");
+        Write(")");
+        if(i != ss->degm) Write(",");
     }
-    fprintf(f, "))\n");
-    fprintf(f, "REPRESENTATION_ITEM('')\n");
-    fprintf(f, "SURFACE()\n");
-    fprintf(f, ");\n");
+    Write("))\n");
+    Write("REPRESENTATION_ITEM('')\n");
+    Write("SURFACE()\n");
+    Write(");\n");
 
     // The control points for the untrimmed surface.
     for(i = 0; i <= ss->degm; i++) {
         for(j = 0; j <= ss->degn; j++) {
-            fprintf(f, "#%d=CARTESIAN_POINT('',(%.10f,%.10f,%.10f));\n",
-                srfid + 1 + j + i*(ss->degn + 1),
-                CO(ss->ctrl[i][j]));
+            WritePoint(srfid + 1 + j + i*(ss->degn + 1), ss->ctrl[i][j]);
         }
     }
-    fprintf(f, "\n");
+    Write("\n");
 
     id = srfid + 1 + (ss->degm + 1)*(ss->degn + 1);
 
-    // Now we do the trim curves. We must group each outer loop separately
-    // along with its inner faces, so do that now.
-    SBezierLoopSetSet sblss = {};
-    SPolygon spxyz = {};
-    bool allClosed;
-    SEdge notClosedAt;
-    // We specify a surface, so it doesn't check for coplanarity; and we
-    // don't want it to give us any open contours. The polygon and chord
-    // tolerance are required, because they are used to calculate the
-    // contour directions and determine inner vs. outer contours.
-    sblss.FindOuterFacesFrom(sbl, &spxyz, ss,
-                             SS.ExportChordTolMm(),
-                             &allClosed, &notClosedAt,
-                             NULL, NULL,
-                             NULL);
-
-    // So in our list of SBezierLoopSet, each set contains at least one loop
-    // (the outer boundary), plus any inner loops associated with that outer
-    // loop.
+    // Now we do the trim curves. So in our list of SBezierLoopSet, each set
+    // contains at least one loop (the outer boundary), plus any inner loops
+    // associated with that outer loop.
     SBezierLoopSet *sbls;
-    for(sbls = sblss.l.First(); sbls; sbls = sblss.l.NextAfter(sbls)) {
+    for(sbls = sblss->l.First(); sbls; sbls = sblss->l.NextAfter(sbls)) {
         SBezierLoop *loop = sbls->l.First();
 
         List<int> listOfLoops = {};
@@ -265,67 +318,66 @@ void StepFileWriter::ExportSurface(SSurface *ss, SBezierList *sbl) {
         // And now create the face that corresponds to this outer loop
         // and all of its holes.
         int advFaceId = id;
-        fprintf(f, "#%d=ADVANCED_FACE('',(", advFaceId);
+        Write("#%d=ADVANCED_FACE('',(", advFaceId);
         int *fb;
         for(fb = listOfLoops.First(); fb; fb = listOfLoops.NextAfter(fb)) {
-            fprintf(f, "#%d", *fb);
-            if(listOfLoops.NextAfter(fb) != NULL) fprintf(f, ",");
+            Write("#%d", *fb);
+            if(listOfLoops.NextAfter(fb) != NULL) Write(",");
         }
 
-        fprintf(f, "),#%d,.T.);\n", srfid);
+        Write("),#%d,.T.);\n", srfid);
         advancedFaces.Add(&advFaceId);
 
         // Export the surface color and transparency
         // https://www.cax-if.org/documents/rec_prac_styling_org_v16.pdf sections 4.4.2 4.2.4 etc.
         // https://tracker.dev.opencascade.org/view.php?id=31550
-        fprintf(f, "#%d=COLOUR_RGB('',%.2f,%.2f,%.2f);\n", ++id, ss->color.redF(),
+        Write("#%d=COLOUR_RGB('',%.2f,%.2f,%.2f);\n", ++id, ss->color.redF(),
                 ss->color.greenF(), ss->color.blueF());
 
 /*      // This works in Kisters 3DViewStation but not in KiCAD and Horison EDA,
         // it seems they do not support transparency so use the more verbose one below
-        fprintf(f, "#%d=SURFACE_STYLE_TRANSPARENT(%.2f);\n", ++id, 1.0 - ss->color.alphaF());
+        Write("#%d=SURFACE_STYLE_TRANSPARENT(%.2f);\n", ++id, 1.0 - ss->color.alphaF());
         ++id;
-        fprintf(f, "#%d=SURFACE_STYLE_RENDERING_WITH_PROPERTIES(.NORMAL_SHADING.,#%d,(#%d));\n",
+        Write("#%d=SURFACE_STYLE_RENDERING_WITH_PROPERTIES(.NORMAL_SHADING.,#%d,(#%d));\n",
                 id, id - 2, id - 1);
         ++id;
-        fprintf(f, "#%d=SURFACE_SIDE_STYLE('',(#%d));\n", id, id - 1);
+        Write("#%d=SURFACE_SIDE_STYLE('',(#%d));\n", id, id - 1);
 */
 
         // This works in Horison EDA but is more verbose.
         ++id;
-        fprintf(f, "#%d=FILL_AREA_STYLE_COLOUR('',#%d);\n", id, id - 1);
+        Write("#%d=FILL_AREA_STYLE_COLOUR('',#%d);\n", id, id - 1);
         ++id;
-        fprintf(f, "#%d=FILL_AREA_STYLE('',(#%d));\n", id, id - 1);
+        Write("#%d=FILL_AREA_STYLE('',(#%d));\n", id, id - 1);
         ++id;
-        fprintf(f, "#%d=SURFACE_STYLE_FILL_AREA(#%d);\n", id, id - 1);
-        fprintf(f, "#%d=SURFACE_STYLE_TRANSPARENT(%.2f);\n", ++id, 1.0 - ss->color.alphaF());
+        Write("#%d=SURFACE_STYLE_FILL_AREA(#%d);\n", id, id - 1);
+        Write("#%d=SURFACE_STYLE_TRANSPARENT(%.2f);\n", ++id, 1.0 - ss->color.alphaF());
         ++id;
-        fprintf(f, "#%d=SURFACE_STYLE_RENDERING_WITH_PROPERTIES(.NORMAL_SHADING.,#%d,(#%d));\n", id, id - 5, id - 1);
+        Write("#%d=SURFACE_STYLE_RENDERING_WITH_PROPERTIES(.NORMAL_SHADING.,#%d,(#%d));\n", id, id - 5, id - 1);
         ++id;
-        fprintf(f, "#%d=SURFACE_SIDE_STYLE('',(#%d, #%d));\n", id, id - 3, id - 1);
+        Write("#%d=SURFACE_SIDE_STYLE('',(#%d, #%d));\n", id, id - 3, id - 1);
 
         ++id;
-        fprintf(f, "#%d=SURFACE_STYLE_USAGE(.BOTH.,#%d);\n", id, id - 1);
+        Write("#%d=SURFACE_STYLE_USAGE(.BOTH.,#%d);\n", id, id - 1);
         ++id;
-        fprintf(f, "#%d=PRESENTATION_STYLE_ASSIGNMENT((#%d));\n", id, id - 1);
+        Write("#%d=PRESENTATION_STYLE_ASSIGNMENT((#%d));\n", id, id - 1);
         ++id;
-        fprintf(f, "#%d=STYLED_ITEM('',(#%d),#%d);\n", id, id - 1, advFaceId);
-        fprintf(f, "\n");        
+        Write("#%d=STYLED_ITEM('',(#%d),#%d);\n", id, id - 1, advFaceId);
+        Write("\n");        
         
         id++;
         listOfLoops.Clear();
     }
-    sblss.Clear();
-    spxyz.Clear();
 }
 
 void StepFileWriter::WriteFooter() {
-    fprintf(f,
+    Write(
 "\n"
 "ENDSEC;\n"
 "\n"
 "END-ISO-10303-21;\n"
         );
+    Flush();
 }
 
 void StepFileWriter::ExportSurfacesTo(const Platform::Path &filename) {
@@ -353,36 +405,84 @@ void StepFileWriter::ExportSurfacesTo(const Platform::Path &filename) {
 
     advancedFaces = {};
 
+    std::vector<SSurface *> surfaces;
     for(SSurface &ss : shell->surface) {
         if(ss.trim.IsEmpty())
             continue;
+        surfaces.push_back(&ss);
+    }
+    int n = (int)surfaces.size(), i;
+
+    // Get all of the loops of Beziers that trim our surfaces (with each
+    // Bezier split so that we use the section as t goes from 0 to 1). This
+    // reads the neighbouring surfaces, so it's done for all of them before
+    // any surface gets scaled below.
+    std::vector<SBezierList> sbls(n);
+    const SKernelContext *ctx = SKernelContext::Current();
+#pragma omp parallel for
+    for(i = 0; i < n; i++) {
+        SKernelContextScope scope(ctx);
+        sbls[i] = {};
+        surfaces[i]->MakeSectionEdgesInto(shell, NULL, &sbls[i]);
+    }
 
-        // Get all of the loops of Beziers that trim our surface (with each
-        // Bezier split so that we use the section as t goes from 0 to 1), and
-        // the piecewise linearization of those loops in xyz space.
-        SBezierList sbl = {};
-        ss.MakeSectionEdgesInto(shell, NULL, &sbl);
-
-        // Apply the export scale factor.
-        ss.ScaleSelfBy(1.0/SS.exportScale);
-        sbl.ScaleSelfBy(1.0/SS.exportScale);
-
-        ExportSurface(&ss, &sbl);
+    // Apply the export scale factor, group the trim curves into faces, and
+    // work out how many entity IDs each surface needs.
+    std::vector<SBezierLoopSetSet> sblsss(n);
+    std::vector<int> firstId(n + 1);
+#pragma omp parallel for
+    for(i = 0; i < n; i++) {
+        SKernelContextScope scope(ctx);
+        surfaces[i]->ScaleSelfBy(1.0/SS.exportScale);
+        sbls[i].ScaleSelfBy(1.0/SS.exportScale);
+
+        sblsss[i] = {};
+        FindTrimLoops(surfaces[i], &sbls[i], &sblsss[i]);
+        firstId[i + 1] = IdsForSurface(surfaces[i], &sblsss[i]);
+    }
+    firstId[0] = id;
+    for(i = 0; i < n; i++) {
+        firstId[i + 1] += firstId[i];
+    }
 
-        sbl.Clear();
+    // With the IDs assigned, each surface can be written independently into
+    // its own buffer; then concatenate those in order, so that the file is
+    // the same as if we'd written the surfaces one by one.
+    std::vector<StepFileWriter> writers(n);
+#pragma omp parallel for schedule(dynamic)
+    for(i = 0; i < n; i++) {
+        SKernelContextScope scope(ctx);
+        StepFileWriter *sw = &writers[i];
+        *sw = {};
+        sw->id = firstId[i];
+        sw->ExportSurface(surfaces[i], &sblsss[i]);
+        ssassert(sw->id == firstId[i + 1], "Unexpected number of STEP entities");
+
+        sblsss[i].Clear();
+        sbls[i].Clear();
     }
+    for(StepFileWriter &sw : writers) {
+        Flush();
+        buf.swap(sw.buf);
+        for(int af : sw.advancedFaces) {
+            advancedFaces.Add(&af);
+        }
+        sw.advancedFaces.Clear();
+    }
+    writers.clear();
+    id = firstId[n];
 
-    fprintf(f, "#%d=CLOSED_SHELL('',(", id);
+    Write("#%d=CLOSED_SHELL('',(", id);
     int *af;
     for(af = advancedFaces.First(); af; af = advancedFaces.NextAfter(af)) {
-        fprintf(f, "#%d", *af);
-        if(advancedFaces.NextAfter(af) != NULL) fprintf(f, ",");
+        Write("#%d", *af);
+        if(advancedFaces.NextAfter(af) != NULL) Write(",");
     }
-    fprintf(f, "));\n");
-    fprintf(f, "#%d=MANIFOLD_SOLID_BREP('brep',#%d);\n", id+1, id);
-    fprintf(f, "#%d=ADVANCED_BREP_SHAPE_REPRESENTATION('',(#%d,#170),#168);\n",
+    Write("));\n");
+    Write("#%d=MANIFOLD_SOLID_BREP('brep',#%d);\n", id+1, id);
+    Write("#%d=ADVANCED_BREP_SHAPE_REPRESENTATION('',(#%d,#170),#168);\n",
         id+2, id+1);
-    fprintf(f, "#%d=SHAPE_REPRESENTATION_RELATIONSHIP($,$,#169,#%d);\n",
+    Write("#%d=SHAPE_REPRESENTATION_RELATIONSHIP($,$,#169,#%d);\n",
         id+3, id+2);
 
     WriteFooter();
@@ -392,19 +492,18 @@ void StepFileWriter::ExportSurfacesTo(const Platform::Path &filename) {
 }
 
 void StepFileWriter::WriteWireframe() {
-    fprintf(f, "#%d=GEOMETRIC_CURVE_SET('curves',(", id);
+    Write("#%d=GEOMETRIC_CURVE_SET('curves',(", id);
     int *c;
     for(c = curves.First(); c; c = curves.NextAfter(c)) {
-        fprintf(f, "#%d", *c);
-        if(curves.NextAfter(c) != NULL) fprintf(f, ",");
+        Write("#%d", *c);
+        if(curves.NextAfter(c) != NULL) Write(",");
     }
-    fprintf(f, "));\n");
-    fprintf(f, "#%d=GEOMETRICALLY_BOUNDED_WIREFRAME_SHAPE_REPRESENTATION"
+    Write("));\n");
+    Write("#%d=GEOMETRICALLY_BOUNDED_WIREFRAME_SHAPE_REPRESENTATION"
                     "('',(#%d,#170),#168);\n", id+1, id);
-    fprintf(f, "#%d=SHAPE_REPRESENTATION_RELATIONSHIP($,$,#169,#%d);\n",
+    Write("#%d=SHAPE_REPRESENTATION_RELATIONSHIP($,$,#169,#%d);\n",
         id+2, id+1);
 
     id += 3;
     curves.Clear();
 }
-
@@ -680,7 +680,7 @@ static std::string MakeStipplePattern(StipplePattern pattern, double scale, char
 }
 
 void EpsFileWriter::StartFile() {
-    fprintf(f,
+    Write(
 "%%!PS-Adobe-2.0\r\n"
 "%%%%Creator: SolveSpace\r\n"
 "%%%%Title: title\r\n"
@@ -702,7 +702,7 @@ void EpsFileWriter::Background(RgbaColor color) {
     double width  = ptMax.x - ptMin.x;
     double height = ptMax.y - ptMin.y;
 
-    fprintf(f,
+    Write(
 "%.3f %.3f %.3f setrgbcolor\r\n"
 "newpath\r\n"
 "    %.3f %.3f moveto\r\n"
@@ -719,7 +719,7 @@ void EpsFileWriter::Background(RgbaColor color) {
 
     // same issue with cracks, stroke it to avoid them
     double sw = max(width, height) / 1000;
-    fprintf(f,
+    Write(
 "1 setlinejoin\r\n"
 "1 setlinecap\r\n"
 "%.3f setlinewidth\r\n"
@@ -730,7 +730,7 @@ void EpsFileWriter::Background(RgbaColor color) {
 void EpsFileWriter::StartPath(RgbaColor strokeRgb, double lineWidth,
                               bool filled, RgbaColor fillRgb, hStyle hs)
 {
-    fprintf(f, "newpath\r\n");
+    Write("newpath\r\n");
     prevPt = Vector::From(VERY_POSITIVE, VERY_POSITIVE, VERY_POSITIVE);
 }
 void EpsFileWriter::FinishPath(RgbaColor strokeRgb, double lineWidth,
@@ -739,7 +739,7 @@ void EpsFileWriter::FinishPath(RgbaColor strokeRgb, double lineWidth,
     StipplePattern pattern = Style::PatternType(hs);
     double stippleScale = MmToPts(Style::StippleScaleMm(hs));
 
-    fprintf(f, "    %.3f setlinewidth\r\n"
+    Write("    %.3f setlinewidth\r\n"
                "    %.3f %.3f %.3f setrgbcolor\r\n"
                "    1 setlinejoin\r\n"  // rounded
                "    1 setlinecap\r\n"   // rounded
@@ -749,7 +749,7 @@ void EpsFileWriter::FinishPath(RgbaColor strokeRgb, double lineWidth,
         strokeRgb.redF(), strokeRgb.greenF(), strokeRgb.blueF(),
         MakeStipplePattern(pattern, stippleScale, ' ').c_str());
     if(filled) {
-        fprintf(f, "    %.3f %.3f %.3f setrgbcolor\r\n"
+        Write("    %.3f %.3f %.3f setrgbcolor\r\n"
                    "    gsave fill grestore\r\n",
             fillRgb.redF(), fillRgb.greenF(), fillRgb.blueF());
     }
@@ -757,34 +757,36 @@ void EpsFileWriter::FinishPath(RgbaColor strokeRgb, double lineWidth,
 
 void EpsFileWriter::MaybeMoveTo(Vector st, Vector fi) {
     if(!prevPt.Equals(st)) {
-        fprintf(f, "    %.3f %.3f moveto\r\n",
-            MmToPts(st.x - ptMin.x), MmToPts(st.y - ptMin.y));
+        Write("    ");
+        WriteXy(MmToPts(st.x - ptMin.x), MmToPts(st.y - ptMin.y), ' ');
+        Write(" moveto\r\n");
     }
     prevPt = fi;
 }
 
 void EpsFileWriter::Triangle(STriangle *tr) {
-    fprintf(f,
-"%.3f %.3f %.3f setrgbcolor\r\n"
-"newpath\r\n"
-"    %.3f %.3f moveto\r\n"
-"    %.3f %.3f lineto\r\n"
-"    %.3f %.3f lineto\r\n"
-"    closepath\r\n"
-"gsave fill grestore\r\n",
-            tr->meta.color.redF(), tr->meta.color.greenF(), tr->meta.color.blueF(),
-            MmToPts(tr->a.x - ptMin.x), MmToPts(tr->a.y - ptMin.y),
-            MmToPts(tr->b.x - ptMin.x), MmToPts(tr->b.y - ptMin.y),
-            MmToPts(tr->c.x - ptMin.x), MmToPts(tr->c.y - ptMin.y));
+    WriteRgb(tr->meta.color);
+    Write(" setrgbcolor\r\n"
+          "newpath\r\n"
+          "    ");
+    WriteXy(MmToPts(tr->a.x - ptMin.x), MmToPts(tr->a.y - ptMin.y), ' ');
+    Write(" moveto\r\n"
+          "    ");
+    WriteXy(MmToPts(tr->b.x - ptMin.x), MmToPts(tr->b.y - ptMin.y), ' ');
+    Write(" lineto\r\n"
+          "    ");
+    WriteXy(MmToPts(tr->c.x - ptMin.x), MmToPts(tr->c.y - ptMin.y), ' ');
+    Write(" lineto\r\n"
+          "    closepath\r\n"
+          "gsave fill grestore\r\n");
 
     // same issue with cracks, stroke it to avoid them
     double sw = max(ptMax.x - ptMin.x, ptMax.y - ptMin.y) / 1000;
-    fprintf(f,
-"1 setlinejoin\r\n"
-"1 setlinecap\r\n"
-"%.3f setlinewidth\r\n"
-"gsave stroke grestore\r\n",
-            MmToPts(sw));
+    Write("1 setlinejoin\r\n"
+          "1 setlinecap\r\n");
+    WriteNumber(MmToPts(sw));
+    Write(" setlinewidth\r\n"
+          "gsave stroke grestore\r\n");
 }
 
 void EpsFileWriter::Bezier(SBezier *sb) {
@@ -792,16 +794,17 @@ void EpsFileWriter::Bezier(SBezier *sb) {
     double r;
     if(sb->deg == 1) {
         MaybeMoveTo(sb->ctrl[0], sb->ctrl[1]);
-        fprintf(f,     "    %.3f %.3f lineto\r\n",
-                MmToPts(sb->ctrl[1].x - ptMin.x),
-                MmToPts(sb->ctrl[1].y - ptMin.y));
+        Write("    ");
+        WriteXy(MmToPts(sb->ctrl[1].x - ptMin.x),
+                MmToPts(sb->ctrl[1].y - ptMin.y), ' ');
+        Write(" lineto\r\n");
     } else if(sb->IsCircle(n, &c, &r)) {
         Vector p0 = sb->ctrl[0], p1 = sb->ctrl[2];
         double theta0 = atan2(p0.y - c.y, p0.x - c.x),
                theta1 = atan2(p1.y - c.y, p1.x - c.x),
                dtheta = WRAP_SYMMETRIC(theta1 - theta0, 2*PI);
         MaybeMoveTo(p0, p1);
-        fprintf(f,
+        Write(
 "    %.3f %.3f %.3f %.3f %.3f %s\r\n",
             MmToPts(c.x - ptMin.x),  MmToPts(c.y - ptMin.y),
             MmToPts(r),
@@ -809,21 +812,24 @@ void EpsFileWriter::Bezier(SBezier *sb) {
             dtheta < 0 ? "arcn" : "arc");
     } else if(sb->deg == 3 && !sb->IsRational()) {
         MaybeMoveTo(sb->ctrl[0], sb->ctrl[3]);
-        fprintf(f,
-"    %.3f %.3f %.3f %.3f %.3f %.3f curveto\r\n",
-            MmToPts(sb->ctrl[1].x - ptMin.x), MmToPts(sb->ctrl[1].y - ptMin.y),
-            MmToPts(sb->ctrl[2].x - ptMin.x), MmToPts(sb->ctrl[2].y - ptMin.y),
-            MmToPts(sb->ctrl[3].x - ptMin.x), MmToPts(sb->ctrl[3].y - ptMin.y));
+        Write("    ");
+        for(int i = 1; i <= 3; i++) {
+            WriteXy(MmToPts(sb->ctrl[i].x - ptMin.x),
+                    MmToPts(sb->ctrl[i].y - ptMin.y), ' ');
+            Write(" ");
+        }
+        Write("curveto\r\n");
     } else {
         BezierAsNonrationalCubic(sb);
     }
 }
 
 void EpsFileWriter::FinishAndCloseFile() {
-    fprintf(f,
+    Write(
 "\r\n"
 "grestore\r\n"
 "\r\n");
+    Flush();
     fclose(f);
 }
 
@@ -839,13 +845,13 @@ void PdfFileWriter::StartFile() {
                   "reject this file."));
     }
 
-    fprintf(f,
+    Write(
 "%%PDF-1.1\r\n"
 "%%%c%c%c%c\r\n",
         0xe2, 0xe3, 0xcf, 0xd3);
 
-    xref[1] = (uint32_t)ftell(f);
-    fprintf(f,
+    xref[1] = Tell();
+    Write(
 "1 0 obj\r\n"
 "  << /Type /Catalog\r\n"
 "     /Outlines 2 0 R\r\n"
@@ -853,16 +859,16 @@ void PdfFileWriter::StartFile() {
 "  >>\r\n"
 "endobj\r\n");
 
-    xref[2] = (uint32_t)ftell(f);
-    fprintf(f,
+    xref[2] = Tell();
+    Write(
 "2 0 obj\r\n"
 "  << /Type /Outlines\r\n"
 "     /Count 0\r\n"
 "  >>\r\n"
 "endobj\r\n");
 
-    xref[3] = (uint32_t)ftell(f);
-    fprintf(f,
+    xref[3] = Tell();
+    Write(
 "3 0 obj\r\n"
 "  << /Type /Pages\r\n"
 "     /Kids [4 0 R]\r\n"
@@ -870,8 +876,8 @@ void PdfFileWriter::StartFile() {
 "  >>\r\n"
 "endobj\r\n");
 
-    xref[4] = (uint32_t)ftell(f);
-    fprintf(f,
+    xref[4] = Tell();
+    Write(
 "4 0 obj\r\n"
 "  << /Type /Page\r\n"
 "     /Parent 3 0 R\r\n"
@@ -885,36 +891,36 @@ void PdfFileWriter::StartFile() {
             MmToPts(ptMax.x - ptMin.x),
             MmToPts(ptMax.y - ptMin.y));
 
-    xref[5] = (uint32_t)ftell(f);
-    fprintf(f,
+    xref[5] = Tell();
+    Write(
 "5 0 obj\r\n"
 "  << /Length 6 0 R >>\r\n"
 "stream\r\n");
-    bodyStart = (uint32_t)ftell(f);
+    bodyStart = Tell();
 }
 
 void PdfFileWriter::FinishAndCloseFile() {
-    uint32_t bodyEnd = (uint32_t)ftell(f);
+    uint32_t bodyEnd = Tell();
 
-    fprintf(f,
+    Write(
 "endstream\r\n"
 "endobj\r\n");
 
-    xref[6] = (uint32_t)ftell(f);
-    fprintf(f,
+    xref[6] = Tell();
+    Write(
 "6 0 obj\r\n"
 "  %d\r\n"
 "endobj\r\n",
         bodyEnd - bodyStart);
 
-    xref[7] = (uint32_t)ftell(f);
-    fprintf(f,
+    xref[7] = Tell();
+    Write(
 "7 0 obj\r\n"
 "  [/PDF /Text]\r\n"
 "endobj\r\n");
 
-    xref[8] = (uint32_t)ftell(f);
-    fprintf(f,
+    xref[8] = Tell();
+    Write(
 "8 0 obj\r\n"
 "  << /Type /Font\r\n"
 "     /Subtype /Type1\r\n"
@@ -924,24 +930,24 @@ void PdfFileWriter::FinishAndCloseFile() {
 "  >>\r\n"
 "endobj\r\n");
 
-    xref[9] = (uint32_t)ftell(f);
-    fprintf(f,
+    xref[9] = Tell();
+    Write(
 "9 0 obj\r\n"
 "  << /Creator (SolveSpace)\r\n"
 "  >>\r\n");
 
-    uint32_t xrefStart = (uint32_t)ftell(f);
-    fprintf(f,
+    uint32_t xrefStart = Tell();
+    Write(
 "xref\r\n"
 "0 10\r\n"
 "0000000000 65535 f\r\n");
 
     int i;
     for(i = 1; i <= 9; i++) {
-        fprintf(f, "%010d %05d n\r\n", xref[i], 0);
+        Write("%010d %05d n\r\n", xref[i], 0);
     }
 
-    fprintf(f,
+    Write(
 "\r\n"
 "trailer\r\n"
 "  << /Size 10\r\n"
@@ -953,6 +959,7 @@ void PdfFileWriter::FinishAndCloseFile() {
 "%%%%EOF\r\n",
         xrefStart);
 
+    Flush();
     fclose(f);
 
 }
@@ -962,7 +969,7 @@ void PdfFileWriter::Background(RgbaColor color) {
     double height = ptMax.y - ptMin.y;
     double sw     = max(width, height) / 1000;
 
-    fprintf(f,
+    Write(
 "1 J 1 j\r\n"
 "%.3f %.3f %.3f RG\r\n"
 "%.3f %.3f %.3f rg\r\n"
@@ -987,14 +994,14 @@ void PdfFileWriter::StartPath(RgbaColor strokeRgb, double lineWidth,
     StipplePattern pattern = Style::PatternType(hs);
     double stippleScale = MmToPts(Style::StippleScaleMm(hs));
 
-    fprintf(f, "1 J 1 j " // round endcaps and joins
+    Write("1 J 1 j " // round endcaps and joins
                "%.3f w [%s] 0 d "
                "%.3f %.3f %.3f RG\r\n",
         MmToPts(lineWidth),
         MakeStipplePattern(pattern, stippleScale, ' ').c_str(),
         strokeRgb.redF(), strokeRgb.greenF(), strokeRgb.blueF());
     if(filled) {
-        fprintf(f, "%.3f %.3f %.3f rg\r\n",
+        Write("%.3f %.3f %.3f rg\r\n",
             fillRgb.redF(), fillRgb.greenF(), fillRgb.blueF());
     }
 
@@ -1004,16 +1011,16 @@ void PdfFileWriter::FinishPath(RgbaColor strokeRgb, double lineWidth,
                                bool filled, RgbaColor fillRgb, hStyle hs)
 {
     if(filled) {
-        fprintf(f, "b\r\n");
+        Write("b\r\n");
     } else {
-        fprintf(f, "S\r\n");
+        Write("S\r\n");
     }
 }
 
 void PdfFileWriter::MaybeMoveTo(Vector st, Vector fi) {
     if(!prevPt.Equals(st)) {
-        fprintf(f, "%.3f %.3f m\r\n",
-            MmToPts(st.x - ptMin.x), MmToPts(st.y - ptMin.y));
+        WriteXy(MmToPts(st.x - ptMin.x), MmToPts(st.y - ptMin.y), ' ');
+        Write(" m\r\n");
     }
     prevPt = fi;
 }
@@ -1021,36 +1028,35 @@ void PdfFileWriter::MaybeMoveTo(Vector st, Vector fi) {
 void PdfFileWriter::Triangle(STriangle *tr) {
     double sw = max(ptMax.x - ptMin.x, ptMax.y - ptMin.y) / 1000;
 
-    fprintf(f,
-"1 J 1 j\r\n"
-"%.3f %.3f %.3f RG\r\n"
-"%.3f %.3f %.3f rg\r\n"
-"%.3f w\r\n"
-"%.3f %.3f m\r\n"
-"%.3f %.3f l\r\n"
-"%.3f %.3f l\r\n"
-"b\r\n",
-            tr->meta.color.redF(), tr->meta.color.greenF(), tr->meta.color.blueF(),
-            tr->meta.color.redF(), tr->meta.color.greenF(), tr->meta.color.blueF(),
-            MmToPts(sw),
-            MmToPts(tr->a.x - ptMin.x), MmToPts(tr->a.y - ptMin.y),
-            MmToPts(tr->b.x - ptMin.x), MmToPts(tr->b.y - ptMin.y),
-            MmToPts(tr->c.x - ptMin.x), MmToPts(tr->c.y - ptMin.y));
+    Write("1 J 1 j\r\n");
+    WriteRgb(tr->meta.color);
+    Write(" RG\r\n");
+    WriteRgb(tr->meta.color);
+    Write(" rg\r\n");
+    WriteNumber(MmToPts(sw));
+    Write(" w\r\n");
+    WriteXy(MmToPts(tr->a.x - ptMin.x), MmToPts(tr->a.y - ptMin.y), ' ');
+    Write(" m\r\n");
+    WriteXy(MmToPts(tr->b.x - ptMin.x), MmToPts(tr->b.y - ptMin.y), ' ');
+    Write(" l\r\n");
+    WriteXy(MmToPts(tr->c.x - ptMin.x), MmToPts(tr->c.y - ptMin.y), ' ');
+    Write(" l\r\n"
+          "b\r\n");
 }
 
 void PdfFileWriter::Bezier(SBezier *sb) {
     if(sb->deg == 1) {
         MaybeMoveTo(sb->ctrl[0], sb->ctrl[1]);
-        fprintf(f,
-"%.3f %.3f l\r\n",
-            MmToPts(sb->ctrl[1].x - ptMin.x), MmToPts(sb->ctrl[1].y - ptMin.y));
+        WriteXy(MmToPts(sb->ctrl[1].x - ptMin.x), MmToPts(sb->ctrl[1].y - ptMin.y), ' ');
+        Write(" l\r\n");
     } else if(sb->deg == 3 && !sb->IsRational()) {
         MaybeMoveTo(sb->ctrl[0], sb->ctrl[3]);
-        fprintf(f,
-"%.3f %.3f %.3f %.3f %.3f %.3f c\r\n",
-            MmToPts(sb->ctrl[1].x - ptMin.x), MmToPts(sb->ctrl[1].y - ptMin.y),
-            MmToPts(sb->ctrl[2].x - ptMin.x), MmToPts(sb->ctrl[2].y - ptMin.y),
-            MmToPts(sb->ctrl[3].x - ptMin.x), MmToPts(sb->ctrl[3].y - ptMin.y));
+        for(int i = 1; i <= 3; i++) {
+            WriteXy(MmToPts(sb->ctrl[i].x - ptMin.x),
+                    MmToPts(sb->ctrl[i].y - ptMin.y), ' ');
+            Write(" ");
+        }
+        Write("c\r\n");
     } else {
         BezierAsNonrationalCubic(sb);
     }
@@ -1060,7 +1066,7 @@ void PdfFileWriter::Bezier(SBezier *sb) {
 // Routines for SVG output
 //-----------------------------------------------------------------------------
 void SvgFileWriter::StartFile() {
-    fprintf(f,
+    Write(
 "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.0//EN\" "
     "\"http://www.w3.org/TR/2001/REC-SVG-20010904/DTD/svg10.dtd\">\r\n"
 "<svg xmlns=\"http://www.w3.org/2000/svg\"  "
@@ -1073,15 +1079,15 @@ void SvgFileWriter::StartFile() {
         (ptMax.x - ptMin.x), (ptMax.y - ptMin.y),
         (ptMax.x - ptMin.x), (ptMax.y - ptMin.y));
 
-    fprintf(f, "<style><![CDATA[\r\n");
-    fprintf(f, "polygon {\r\n");
-    fprintf(f, "shape-rendering:crispEdges;\r\n");
+    Write("<style><![CDATA[\r\n");
+    Write("polygon {\r\n");
+    Write("shape-rendering:crispEdges;\r\n");
     // crispEdges turns of anti-aliasing, which tends to cause hairline
     // cracks between triangles; but there still is some cracking, so
     // specify a stroke width too, hope for around a pixel
     double sw = max(ptMax.x - ptMin.x, ptMax.y - ptMin.y) / 1000;
-    fprintf(f, "stroke-width:%f;\r\n", sw);
-    fprintf(f, "}\r\n");
+    Write("stroke-width:%f;\r\n", sw);
+    Write("}\r\n");
 
     auto export_style = [&](hStyle hs) {
         Style *s = Style::Get(hs);
@@ -1090,24 +1096,24 @@ void SvgFileWriter::StartFile() {
         StipplePattern pattern = Style::PatternType(hs);
         double stippleScale = Style::StippleScaleMm(hs);
 
-        fprintf(f, ".s%x {\r\n", hs.v);
-        fprintf(f, "stroke:#%02x%02x%02x;\r\n", strokeRgb.red, strokeRgb.green, strokeRgb.blue);
+        Write(".s%x {\r\n", hs.v);
+        Write("stroke:#%02x%02x%02x;\r\n", strokeRgb.red, strokeRgb.green, strokeRgb.blue);
         // don't know why we have to take a half of the width
-        fprintf(f, "stroke-width:%f;\r\n", Style::WidthMm(hs.v) / 2.0);
-        fprintf(f, "stroke-linecap:round;\r\n");
-        fprintf(f, "stroke-linejoin:round;\r\n");
+        Write("stroke-width:%f;\r\n", Style::WidthMm(hs.v) / 2.0);
+        Write("stroke-linecap:round;\r\n");
+        Write("stroke-linejoin:round;\r\n");
         std::string patternStr = MakeStipplePattern(pattern, stippleScale, ',',
                                                     /*inkscapeWorkaround=*/true);
         if(!patternStr.empty()) {
-            fprintf(f, "stroke-dasharray:%s;\r\n", patternStr.c_str());
+            Write("stroke-dasharray:%s;\r\n", patternStr.c_str());
         }
         if(s->filled) {
-            fprintf(f, "fill:#%02x%02x%02x;\r\n", fillRgb.red, fillRgb.green, fillRgb.blue); 
+            Write("fill:#%02x%02x%02x;\r\n", fillRgb.red, fillRgb.green, fillRgb.blue); 
         }
         else {
-            fprintf(f, "fill:none;\r\n");
+            Write("fill:none;\r\n");
         }
-        fprintf(f, "}\r\n");
+        Write("}\r\n");
     };
 
     export_style({Style::NO_STYLE});
@@ -1115,11 +1121,11 @@ void SvgFileWriter::StartFile() {
         Style *s = &style;
         export_style(s->h);
     }
-    fprintf(f, "]]></style>\r\n");
+    Write("]]></style>\r\n");
 }
 
 void SvgFileWriter::Background(RgbaColor color) {
-    fprintf(f,
+    Write(
 "<style><![CDATA[\r\n"
 "svg {\r\n"
 "background-color:#%02x%02x%02x;\r\n"
@@ -1131,7 +1137,7 @@ void SvgFileWriter::Background(RgbaColor color) {
 void SvgFileWriter::StartPath(RgbaColor strokeRgb, double lineWidth,
                               bool filled, RgbaColor fillRgb, hStyle hs)
 {
-    fprintf(f, "<path d='");
+    Write("<path d='");
     prevPt = Vector::From(VERY_POSITIVE, VERY_POSITIVE, VERY_POSITIVE);
 }
 void SvgFileWriter::FinishPath(RgbaColor strokeRgb, double lineWidth,
@@ -1143,25 +1149,29 @@ void SvgFileWriter::FinishPath(RgbaColor strokeRgb, double lineWidth,
             fillRgb.red, fillRgb.green, fillRgb.blue);
     }
     std::string cls = ssprintf("s%x", hs.v);
-    fprintf(f, "' class='%s' %s/>\r\n", cls.c_str(), fill.c_str());
+    Write("' class='%s' %s/>\r\n", cls.c_str(), fill.c_str());
 }
 
 void SvgFileWriter::MaybeMoveTo(Vector st, Vector fi) {
     // SVG uses a coordinate system with the origin at top left, +y down
     if(!prevPt.Equals(st)) {
-        fprintf(f, "M%.3f %.3f ", (st.x - ptMin.x), (ptMax.y - st.y));
+        Write("M");
+        WriteXy(st.x - ptMin.x, ptMax.y - st.y, ' ');
+        Write(" ");
     }
     prevPt = fi;
 }
 
 void SvgFileWriter::Triangle(STriangle *tr) {
-    fprintf(f,
-"<polygon points='%.3f,%.3f %.3f,%.3f %.3f,%.3f' "
-    "stroke='#%02x%02x%02x' "
-    "fill='#%02x%02x%02x'/>\r\n",
-            (tr->a.x - ptMin.x), (ptMax.y - tr->a.y),
-            (tr->b.x - ptMin.x), (ptMax.y - tr->b.y),
-            (tr->c.x - ptMin.x), (ptMax.y - tr->c.y),
+    Write("<polygon points='");
+    WriteXy(tr->a.x - ptMin.x, ptMax.y - tr->a.y, ',');
+    Write(" ");
+    WriteXy(tr->b.x - ptMin.x, ptMax.y - tr->b.y, ',');
+    Write(" ");
+    WriteXy(tr->c.x - ptMin.x, ptMax.y - tr->c.y, ',');
+    Write("' "
+          "stroke='#%02x%02x%02x' "
+          "fill='#%02x%02x%02x'/>\r\n",
             tr->meta.color.red, tr->meta.color.green, tr->meta.color.blue,
             tr->meta.color.red, tr->meta.color.green, tr->meta.color.blue);
 }
@@ -1171,8 +1181,9 @@ void SvgFileWriter::Bezier(SBezier *sb) {
     double r;
     if(sb->deg == 1) {
         MaybeMoveTo(sb->ctrl[0], sb->ctrl[1]);
-        fprintf(f, "L%.3f,%.3f ",
-            (sb->ctrl[1].x - ptMin.x), (ptMax.y - sb->ctrl[1].y));
+        Write("L");
+        WriteXy(sb->ctrl[1].x - ptMin.x, ptMax.y - sb->ctrl[1].y, ',');
+        Write(" ");
     } else if(sb->IsCircle(n, &c, &r)) {
         Vector p0 = sb->ctrl[0], p1 = sb->ctrl[2];
         double theta0 = atan2(p0.y - c.y, p0.x - c.x),
@@ -1184,22 +1195,25 @@ void SvgFileWriter::Bezier(SBezier *sb) {
         // Note that clockwise and counter-clockwise are backwards in SVG's
         // mirrored csys.
         MaybeMoveTo(p0, p1);
-        fprintf(f, "A%.3f,%.3f 0 0,%d %.3f,%.3f ",
+        Write("A%.3f,%.3f 0 0,%d %.3f,%.3f ",
                         r, r,
                         (dtheta < 0) ? 1 : 0,
                         p1.x - ptMin.x, ptMax.y - p1.y);
     } else if(!sb->IsRational()) {
         if(sb->deg == 2) {
             MaybeMoveTo(sb->ctrl[0], sb->ctrl[2]);
-            fprintf(f, "Q%.3f,%.3f %.3f,%.3f ",
-                sb->ctrl[1].x - ptMin.x, ptMax.y - sb->ctrl[1].y,
-                sb->ctrl[2].x - ptMin.x, ptMax.y - sb->ctrl[2].y);
+            Write("Q");
+            for(int i = 1; i <= 2; i++) {
+                WriteXy(sb->ctrl[i].x - ptMin.x, ptMax.y - sb->ctrl[i].y, ',');
+                Write(" ");
+            }
         } else if(sb->deg == 3) {
             MaybeMoveTo(sb->ctrl[0], sb->ctrl[3]);
-            fprintf(f, "C%.3f,%.3f %.3f,%.3f %.3f,%.3f ",
-                sb->ctrl[1].x - ptMin.x, ptMax.y - sb->ctrl[1].y,
-                sb->ctrl[2].x - ptMin.x, ptMax.y - sb->ctrl[2].y,
-                sb->ctrl[3].x - ptMin.x, ptMax.y - sb->ctrl[3].y);
+            Write("C");
+            for(int i = 1; i <= 3; i++) {
+                WriteXy(sb->ctrl[i].x - ptMin.x, ptMax.y - sb->ctrl[i].y, ',');
+                Write(" ");
+            }
         }
     } else {
         BezierAsNonrationalCubic(sb);
@@ -1207,7 +1221,8 @@ void SvgFileWriter::Bezier(SBezier *sb) {
 }
 
 void SvgFileWriter::FinishAndCloseFile() {
-    fprintf(f, "\r\n</svg>\r\n");
+    Write("\r\n</svg>\r\n");
+    Flush();
     fclose(f);
 }
 
@@ -1219,8 +1234,8 @@ double HpglFileWriter::MmToHpglUnits(double mm) {
 }
 
 void HpglFileWriter::StartFile() {
-    fprintf(f, "IN;\r\n");
-    fprintf(f, "SP1;\r\n");
+    Write("IN;\r\n");
+    Write("SP1;\r\n");
 }
 
 void HpglFileWriter::Background(RgbaColor color) {
@@ -1240,10 +1255,10 @@ void HpglFileWriter::Triangle(STriangle *tr) {
 
 void HpglFileWriter::Bezier(SBezier *sb) {
     if(sb->deg == 1) {
-        fprintf(f, "PU%d,%d;\r\n",
+        Write("PU%d,%d;\r\n",
             (int)MmToHpglUnits(sb->ctrl[0].x),
             (int)MmToHpglUnits(sb->ctrl[0].y));
-        fprintf(f, "PD%d,%d;\r\n",
+        Write("PD%d,%d;\r\n",
             (int)MmToHpglUnits(sb->ctrl[1].x),
             (int)MmToHpglUnits(sb->ctrl[1].y));
     } else {
@@ -1252,6 +1267,7 @@ void HpglFileWriter::Bezier(SBezier *sb) {
 }
 
 void HpglFileWriter::FinishAndCloseFile() {
+    Flush();
     fclose(f);
 }
 
@@ -1297,25 +1313,26 @@ void GCodeFileWriter::FinishAndCloseFile() {
             if(sc->l.n < 2) continue;
 
             SPoint *pt = sc->l.First();
-            fprintf(f, "G00 X%s Y%s\r\n",
+            Write("G00 X%s Y%s\r\n",
                     SS.MmToString(pt->p.x).c_str(), SS.MmToString(pt->p.y).c_str());
-            fprintf(f, "G01 Z%s F%s\r\n",
+            Write("G01 Z%s F%s\r\n",
                     SS.MmToString(depth).c_str(), SS.MmToString(SS.gCode.plungeFeed).c_str());
 
             pt = sc->l.NextAfter(pt);
             for(; pt; pt = sc->l.NextAfter(pt)) {
-                fprintf(f, "G01 X%s Y%s F%s\r\n",
+                Write("G01 X%s Y%s F%s\r\n",
                         SS.MmToString(pt->p.x).c_str(), SS.MmToString(pt->p.y).c_str(),
                         SS.MmToString(SS.gCode.feed).c_str());
             }
             // Move up to a clearance plane 5mm above the work.
-            fprintf(f, "G00 Z%s\r\n",
+            Write("G00 Z%s\r\n",
                     SS.MmToString(SS.gCode.depth < 0 ? +5 : -5).c_str());
         }
     }
 
     sp.Clear();
     sel.Clear();
+    Flush();
     fclose(f);
 }
 
@@ -491,15 +491,29 @@ Expr *Expr::FoldConstants() {
     return n;
 }
 
-void Expr::Substitute(hParam oldh, hParam newh) {
+// Replace every param that appears in subst (by handle) with its new
+// expression, in place.
+void Expr::Substitute(const std::unordered_map<uint32_t, Substitution> &subst) {
     ssassert(op != Op::PARAM_PTR, "Expected an expression that refer to params via handles");
 
-    if(op == Op::PARAM && parh == oldh) {
-        parh = newh;
+    if(op == Op::PARAM) {
+        auto it = subst.find(parh.v);
+        if(it == subst.end()) return;
+
+        const Substitution &s = it->second;
+        if(s.scale == 1.0 && s.offset == 0.0) {
+            parh = s.param;
+        } else {
+            Expr *r = From(s.param);
+            if(s.scale != 1.0) r = r->Negate();
+            if(s.offset != 0.0) r = r->Plus(From(s.offset));
+            *this = *r;
+        }
+        return;
     }
     int c = Children();
-    if(c >= 1) a->Substitute(oldh, newh);
-    if(c >= 2) b->Substitute(oldh, newh);
+    if(c >= 1) a->Substitute(subst);
+    if(c >= 2) b->Substitute(subst);
 }
 
 //-----------------------------------------------------------------------------
@@ -540,6 +554,23 @@ hParam Expr::ReferencedParams(ParamList *pl) const {
     } else ssassert(false, "Unexpected children count");
 }
 
+//-----------------------------------------------------------------------------
+// Append each param that the expression references to found, once.
+//-----------------------------------------------------------------------------
+void Expr::ReferencedParams(std::vector<hParam> *found) const {
+    if(op == Op::PARAM) {
+        if(std::find(found->begin(), found->end(), parh) == found->end()) {
+            found->push_back(parh);
+        }
+        return;
+    }
+    ssassert(op != Op::PARAM_PTR, "Expected an expression that refer to params via handles");
+
+    int c = Children();
+    if(c >= 1) a->ReferencedParams(found);
+    if(c >= 2) b->ReferencedParams(found);
+}
+
 
 //-----------------------------------------------------------------------------
 // Routines to pretty-print an expression. Mostly for debugging.
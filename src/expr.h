@@ -49,7 +49,7 @@ public:
     Expr(double val) : op(Op::CONSTANT) { v = val; }
 
     static inline Expr *AllocExpr()
-        { return (Expr *)AllocTemporary(sizeof(Expr)); }
+        { return (Expr *)AllocTemporaryUninitialized(sizeof(Expr)); }
 
     static Expr *From(hParam p);
     static Expr *From(double v);
@@ -74,10 +74,18 @@ public:
     bool DependsOn(hParam p) const;
     static bool Tol(double a, double b);
     Expr *FoldConstants();
-    void Substitute(hParam oldh, hParam newh);
+    // When solving by substitution, a param is replaced with
+    // scale*param + offset, where the scale is 1 or -1.
+    struct Substitution {
+        hParam  param;
+        double  scale;
+        double  offset;
+    };
+    void Substitute(const std::unordered_map<uint32_t, Substitution> &subst);
 
     static const hParam NO_PARAMS, MULTIPLE_PARAMS;
     hParam ReferencedParams(ParamList *pl) const;
+    void ReferencedParams(std::vector<hParam> *found) const;
 
     void ParamsToPointers();
 
@@ -32,6 +32,7 @@ void SolveSpaceUI::ClearExisting() {
     SK.style.Clear();
 
     SK.entity.Clear();
+    SK.pointIndex.Clear();
     SK.param.Clear();
     images.clear();
 }
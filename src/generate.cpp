@@ -213,6 +213,7 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
     int oldEntityCount = SK.entity.n;
     SK.entity.Clear();
     SK.entity.ReserveMore(oldEntityCount);
+    std::vector<hGroup> solved;
 
     // Not using range-for because we're using the index inside the loop.
     for(i = 0; i < SK.groupOrder.n; i++) {
@@ -255,6 +256,7 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
                 newp->free = prevp->free;
             }
         }
+        SK.GetGroup(hg)->InvalidateCopyTransforms();
 
         if(hg == Group::HGROUP_REFERENCES) {
             ForceReferences();
@@ -267,9 +269,11 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
                 // The group falls inside the range, so really solve it,
                 // and then regenerate the mesh based on the solved stuff.
                 Group *g = SK.GetGroup(hg);
+                g->profile.stale = false;
                 if(genForBBox) {
                     SolveGroupAndReport(hg, andFindFree);
                     g->GenerateLoops();
+                    solved.push_back(hg);
                 } else {
                     g->GenerateShellAndMesh();
                     g->clean = true;
@@ -278,6 +282,7 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
                 // The group falls outside the range, so just assume that
                 // it's good wherever we left it. The mesh is unchanged,
                 // and the parameters must be marked as known.
+                SK.GetGroup(hg)->profile.stale = true;
                 for(auto &p : SK.param) {
                     Param *newp = &p;
 
@@ -288,6 +293,9 @@ void SolveSpaceUI::GenerateAll(Generate type, bool andFindFree, bool genForBBox)
         }
     }
 
+    // The points of the groups that moved must be found where they are now.
+    SK.pointIndex.Build(solved);
+
     // And update any reference dimensions with their new values
     for(auto &con : SK.constraint) {
         Constraint *c = &con;
@@ -530,10 +538,13 @@ void SolveSpaceUI::WriteEqSystemForGroup(hGroup hg) {
 }
 
 void SolveSpaceUI::SolveGroup(hGroup hg, bool andFindFree) {
+    double start = GetMillisecondsPrecise();
     WriteEqSystemForGroup(hg);
+    double writtenMs = GetMillisecondsPrecise() - start;
     Group *g = SK.GetGroup(hg);
     g->solved.remove.Clear();
     g->solved.findToFixTimeout = SS.timeoutRedundantConstr;
+    sys.algorithm = SS.solverAlgorithm;
     SolveResult how = sys.Solve(g, NULL,
                                    &(g->solved.dof),
                                    &(g->solved.remove),
@@ -544,7 +555,12 @@ void SolveSpaceUI::SolveGroup(hGroup hg, bool andFindFree) {
         g->dofCheckOk = true;
     }
     g->solved.how = how;
+    g->InvalidateCopyTransforms();
     FreeAllTemporary();
+
+    g->profile.solve = sys.stats;
+    g->profile.solve.writeEquationsMs += writtenMs;
+    g->profile.solveMs = GetMillisecondsPrecise() - start;
 }
 
 SolveResult SolveSpaceUI::TestRankForGroup(hGroup hg, int *rank) {
@@ -977,13 +977,37 @@ void GraphicsWindow::DeleteTaggedRequests() {
             r.tag = 1;
     }
     // Rewrite any point-coincident constraints that were affected by this
-    // deletion.
+    // deletion, all at once for the points of every tagged request in the
+    // active group.
+    std::unordered_set<uint32_t> tagged;
+    std::set<hGroup> groups;
     for(Request &r : SK.request) {
         if(!r.tag) continue;
-        FixConstraintsForRequestBeingDeleted(r.h);
+        groups.insert(r.group);
+        if(r.group != activeGroup) continue;
+        tagged.insert(r.h.v);
     }
+    std::vector<hEntity> hpts;
+    for(Entity &e : SK.entity) {
+        if(!(e.h.isFromRequest())) continue;
+        if(!tagged.count(e.h.request().v)) continue;
+
+        if(e.type != Entity::Type::POINT_IN_2D &&
+           e.type != Entity::Type::POINT_IN_3D)
+        {
+            continue;
+        }
+        hpts.push_back(e.h);
+    }
+    FixConstraintsForPointsBeingDeleted(hpts);
+    // Drop everything else that refers to the requests now, rather than
+    // letting the regeneration prune it piece by piece.
+    RemoveConstraintsForTaggedRequests();
     // and then delete the tagged requests.
     SK.request.RemoveTagged();
+    for(hGroup hg : groups) {
+        SS.MarkGroupDirty(hg);
+    }
 
     // An edit might be in progress for the just-deleted item. So
     // now it's not.
@@ -992,8 +1016,9 @@ void GraphicsWindow::DeleteTaggedRequests() {
     // And clear out the selection, which could contain that item.
     ClearSuper();
     // And regenerate to get rid of what it generates, plus anything
-    // that references it (since the regen code checks for that).
-    SS.GenerateAll(SolveSpaceUI::Generate::ALL);
+    // that references it (since the regen code checks for that, in every
+    // group); only the groups that we just dirtied need to be solved.
+    SS.GenerateAll(SolveSpaceUI::Generate::DIRTY);
     EnsureValidActives();
     SS.ScheduleShowTW();
 }
@@ -30,6 +30,7 @@ void Group::Clear() {
     impMesh.Clear();
     impShell.Clear();
     impEntity.Clear();
+    copyTransforms.clear();
     // remap is the only one that doesn't get recreated when we regen
     remap.clear();
 }
@@ -62,6 +63,62 @@ void Group::ExtrusionForceVectorTo(const Vector &v) {
     SK.GetParam(h.param(0))->val = v.x;
     SK.GetParam(h.param(1))->val = v.y;
     SK.GetParam(h.param(2))->val = v.z;
+    InvalidateCopyTransforms();
+}
+
+//-----------------------------------------------------------------------------
+// Return the transform for the copies that were made with the given number
+// of applications, computing it from the params if it's not cached yet. The
+// cache must be invalidated whenever the group's params change. Returns NULL
+// for groups that don't cache their transforms.
+//-----------------------------------------------------------------------------
+const Group::CopyTransform *Group::GetCopyTransform(int timesApplied) {
+    if(type != Type::TRANSLATE && type != Type::ROTATE && type != Type::LINKED) {
+        return NULL;
+    }
+
+    if(copyTransforms.empty()) {
+        // A step and repeat counts from -(n-1) for two-sided groups, up to
+        // 2*n when the first copy is skipped.
+        int n = (type == Type::LINKED) ? 0 : ((int)valA + 1);
+        copyTransformFirst = -n;
+        copyTransforms.resize(3*n + 1);
+    }
+    int i = timesApplied - copyTransformFirst;
+    if(i < 0 || i >= (int)copyTransforms.size()) return NULL;
+
+    CopyTransform *ct = &copyTransforms[i];
+    if(ct->valid) return ct;
+
+    // These must match the arithmetic in EntityBase::PointGetNum() and
+    // NormalGetNum() exactly.
+    ct->offset = Vector::From(h.param(0), h.param(1), h.param(2));
+    switch(type) {
+        case Type::TRANSLATE:
+            ct->displace = ct->offset.ScaledBy(timesApplied);
+            ct->q = Quaternion::IDENTITY;
+            break;
+
+        case Type::ROTATE: {
+            double theta = timesApplied*SK.GetParam(h.param(3))->val;
+            double s = sin(theta), c = cos(theta);
+            ct->q.w  = c;
+            ct->q.vx = s*SK.GetParam(h.param(4))->val;
+            ct->q.vy = s*SK.GetParam(h.param(5))->val;
+            ct->q.vz = s*SK.GetParam(h.param(6))->val;
+            ct->displace = Vector::From(0, 0, 0);
+            break;
+        }
+
+        case Type::LINKED:
+            ct->q = Quaternion::From(h.param(3), h.param(4), h.param(5), h.param(6));
+            ct->displace = Vector::From(0, 0, 0);
+            break;
+
+        default: ssassert(false, "Unexpected group type");
+    }
+    ct->valid = true;
+    return ct;
 }
 
 void Group::MenuGroup(Command id)  {
@@ -376,6 +433,7 @@ void Group::TransformImportedBy(Vector t, Quaternion q) {
     SK.GetParam(qx)->val = qg.vx;
     SK.GetParam(qy)->val = qg.vy;
     SK.GetParam(qz)->val = qg.vz;
+    InvalidateCopyTransforms();
 }
 
 bool Group::IsForcedToMeshBySource() const {
@@ -423,6 +481,7 @@ void Group::Generate(IdList<Entity,hEntity> *entity,
     gn = gn.WithMagnitude(200/SS.GW.scale);
     gp = gp.WithMagnitude(200/SS.GW.scale);
     int a, i;
+    InvalidateCopyTransforms();
     switch(type) {
         case Type::DRAWING_3D:
             return;
@@ -208,6 +208,7 @@ void Group::GenerateForBoolean(T *prevs, T *thiss, T *outs, Group::CombineAs how
 }
 
 void Group::GenerateShellAndMesh() {
+    double start = GetMillisecondsPrecise();
     bool prevBooleanFailed = booleanFailed;
     booleanFailed = false;
 
@@ -399,6 +400,9 @@ void Group::GenerateShellAndMesh() {
 
     Group *prevg = srcg->RunningMeshGroup();
 
+    double meshed = GetMillisecondsPrecise();
+    profile.meshMs = meshed - start;
+
     if(!IsForcedToMesh()) {
         SShell *prevs = &(prevg->runningShell);
         GenerateForBoolean<SShell>(prevs, &thisShell, &runningShell,
@@ -447,6 +451,7 @@ void Group::GenerateShellAndMesh() {
         prevm.Clear();
     }
 
+    profile.booleanMs = GetMillisecondsPrecise() - meshed;
     displayDirty = true;
 }
 
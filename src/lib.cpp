@@ -200,6 +200,10 @@ default: dbp("bad constraint type %d", sc->type); return;
 
     List<hConstraint> bad = {};
 
+    SYS.algorithm = (ssys->algorithm == SLVS_SOLVE_LEVENBERG_MARQUARDT) ?
+                    System::Algorithm::LEVENBERG_MARQUARDT :
+                    System::Algorithm::NEWTON;
+
     // Now we're finally ready to solve!
     bool andFindBad = ssys->calculateFaileds ? true : false;
     SolveResult how = SYS.Solve(&g, NULL, &(ssys->dof), &bad, andFindBad, /*andFindFree=*/false);
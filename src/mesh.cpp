@@ -377,7 +377,7 @@ SKdNode *SKdNode::Alloc()
 
 SKdNode *SKdNode::From(SMesh *m) {
     int i;
-    STriangle *tra = (STriangle *)AllocTemporary((m->l.n) * sizeof(*tra));
+    STriangle *tra = (STriangle *)AllocTemporaryUninitialized((m->l.n) * sizeof(*tra));
 
     for(i = 0; i < m->l.n; i++) {
         tra[i] = m->l[i];
@@ -663,7 +663,7 @@ void SKdNode::SnapToMesh(SMesh *m) {
             SnapToVertex(v, &extra);
 
             for(k = 0; k < extra.l.n; k++) {
-                STriangle *tra = (STriangle *)AllocTemporary(sizeof(*tra));
+                STriangle *tra = (STriangle *)AllocTemporaryUninitialized(sizeof(*tra));
                 *tra = extra.l[k];
                 AddTriangle(tra);
             }
@@ -792,7 +792,8 @@ void SKdNode::SplitLinesAgainstTriangle(SEdgeList *sel, STriangle *tr) const {
 // Given an edge orig, occlusion test it against our mesh. We output an edge
 // list in sel, where only invisible portions of the edge are tagged.
 //-----------------------------------------------------------------------------
-void SKdNode::OcclusionTestLine(SEdge orig, SEdgeList *sel, int cnt) const {
+void SKdNode::ListTrianglesAlong(SEdge orig, std::vector<STriangle *> *tl,
+                                 std::unordered_set<const STriangle *> *seen) const {
     if(gt && lt) {
         double ac = (orig.a).Element(which),
                bc = (orig.b).Element(which);
@@ -802,27 +803,41 @@ void SKdNode::OcclusionTestLine(SEdge orig, SEdgeList *sel, int cnt) const {
            bc < c + KDTREE_EPS ||
            which == 2)
         {
-            lt->OcclusionTestLine(orig, sel, cnt);
+            lt->ListTrianglesAlong(orig, tl, seen);
         }
         if(ac > c - KDTREE_EPS ||
            bc > c - KDTREE_EPS ||
            which == 2)
         {
-            gt->OcclusionTestLine(orig, sel, cnt);
+            gt->ListTrianglesAlong(orig, tl, seen);
         }
     } else {
         STriangleLl *ll;
         for(ll = tris; ll; ll = ll->next) {
             STriangle *tr = ll->tri;
-
-            if(tr->tag == cnt) continue;
-
-            SplitLinesAgainstTriangle(sel, tr);
-            tr->tag = cnt;
+            // A triangle may be referenced from several leaves; visit it once,
+            // the first time we reach it.
+            if(!seen->insert(tr).second) continue;
+            tl->push_back(tr);
         }
     }
 }
 
+//-----------------------------------------------------------------------------
+// Split the edges in sel against every triangle of the tree that might occlude
+// orig, tagging the occluded pieces. The visited triangles are tracked per
+// query rather than through the triangle tags, so that any number of queries
+// may run concurrently against the same tree.
+//-----------------------------------------------------------------------------
+void SKdNode::OcclusionTestLine(SEdge orig, SEdgeList *sel) const {
+    std::vector<STriangle *> tl;
+    std::unordered_set<const STriangle *> seen;
+    ListTrianglesAlong(orig, &tl, &seen);
+    for(STriangle *tr : tl) {
+        SplitLinesAgainstTriangle(sel, tr);
+    }
+}
+
 //-----------------------------------------------------------------------------
 // Search the mesh for a triangle with an edge from b to a (i.e., the mate
 // for the edge from a to b), and increment info->count each time that we
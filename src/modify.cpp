@@ -40,6 +40,51 @@ void GraphicsWindow::RemoveConstraintsForPointBeingDeleted(hEntity hpt) {
     SK.constraint.RemoveTagged();
 }
 
+//-----------------------------------------------------------------------------
+// Remove every constraint that refers to an entity generated by a tagged
+// request, in a single pass; the regeneration would otherwise prune those
+// one at a time, restarting each time.
+//-----------------------------------------------------------------------------
+void GraphicsWindow::RemoveConstraintsForTaggedRequests() {
+    std::unordered_set<uint32_t> tagged;
+    for(Request &r : SK.request) {
+        if(r.tag) tagged.insert(r.h.v);
+    }
+    if(tagged.empty()) return;
+
+    auto isDeleted = [&](hEntity he) {
+        return he.isFromRequest() && tagged.count(he.request().v) != 0;
+    };
+
+    std::set<hGroup> groups;
+    SK.constraint.ClearTags();
+    for(auto &c : SK.constraint) {
+        if(isDeleted(c.workplane) ||
+           isDeleted(c.ptA) ||
+           isDeleted(c.ptB) ||
+           isDeleted(c.entityA) ||
+           isDeleted(c.entityB) ||
+           isDeleted(c.entityC) ||
+           isDeleted(c.entityD))
+        {
+            c.tag = 1;
+            (SS.deleted.constraints)++;
+            if(c.type != Constraint::Type::POINTS_COINCIDENT &&
+               c.type != Constraint::Type::HORIZONTAL &&
+               c.type != Constraint::Type::VERTICAL)
+            {
+                (SS.deleted.nonTrivialConstraints)++;
+            }
+            groups.insert(c.group);
+        }
+    }
+    SK.constraint.RemoveTagged();
+
+    for(hGroup hg : groups) {
+        SS.MarkGroupDirty(hg);
+    }
+}
+
 //-----------------------------------------------------------------------------
 // Let's say that A is coincident with B, and B is coincident with C. This
 // implies that A is coincident with C; but if we delete B, then both
@@ -50,6 +95,7 @@ void GraphicsWindow::FixConstraintsForRequestBeingDeleted(hRequest hr) {
     Request *r = SK.GetRequest(hr);
     if(r->group != SS.GW.activeGroup) return;
 
+    std::vector<hEntity> hpts;
     for(Entity &e : SK.entity) {
         if(!(e.h.isFromRequest())) continue;
         if(e.h.request() != hr) continue;
@@ -62,42 +108,92 @@ void GraphicsWindow::FixConstraintsForRequestBeingDeleted(hRequest hr) {
 
         // This is a point generated by the request being deleted; so fix
         // the constraints for that.
-        FixConstraintsForPointBeingDeleted(e.h);
+        hpts.push_back(e.h);
     }
+    FixConstraintsForPointsBeingDeleted(hpts);
 }
 void GraphicsWindow::FixConstraintsForPointBeingDeleted(hEntity hpt) {
-    List<hEntity> ld = {};
+    FixConstraintsForPointsBeingDeleted({ hpt });
+}
+void GraphicsWindow::FixConstraintsForPointsBeingDeleted(const std::vector<hEntity> &hpts) {
+    if(hpts.empty()) return;
+
+    std::unordered_set<uint32_t> deleted;
+    for(hEntity hpt : hpts) {
+        deleted.insert(hpt.v);
+    }
+
+    // Every point-coincident constraint that mentions a deleted point goes
+    // away; the points that it joined fall into the same coincidence class,
+    // which we track with a union-find over the point handles.
+    std::unordered_map<uint32_t, uint32_t> parent;
+    std::function<uint32_t(uint32_t)> find = [&](uint32_t v) {
+        auto it = parent.find(v);
+        if(it == parent.end()) {
+            parent.emplace(v, v);
+            return v;
+        }
+        if(it->second == v) return v;
+        uint32_t root = find(it->second);
+        parent[v] = root;
+        return root;
+    };
+    // The surviving points, in the order we first met them, so that the
+    // constraints we add back don't depend on hashing.
+    std::vector<hEntity> survivors;
+    std::unordered_set<uint32_t> seen;
 
     SK.constraint.ClearTags();
     for(Constraint &c : SK.constraint) {
         if(c.type != Constraint::Type::POINTS_COINCIDENT) continue;
         if(c.group != SS.GW.activeGroup) continue;
 
-        if(c.ptA == hpt) {
-            ld.Add(&(c.ptB));
-            c.tag = 1;
-        }
-        if(c.ptB == hpt) {
-            ld.Add(&(c.ptA));
-            c.tag = 1;
+        if(!deleted.count(c.ptA.v) && !deleted.count(c.ptB.v)) continue;
+        c.tag = 1;
+
+        uint32_t ra = find(c.ptA.v),
+                 rb = find(c.ptB.v);
+        if(ra != rb) parent[ra] = rb;
+
+        for(hEntity hpt : { c.ptA, c.ptB }) {
+            if(deleted.count(hpt.v)) continue;
+            if(!seen.insert(hpt.v).second) continue;
+            survivors.push_back(hpt);
         }
     }
     // Remove constraints without waiting for regeneration; this way
     // if another point takes the place of the deleted one (e.g. when
     // removing control points of a bezier) the constraint doesn't
-    // spuriously move. Similarly, subsequent calls of this function
-    // (if multiple coincident points are getting deleted) will work
-    // correctly.
+    // spuriously move.
     SK.constraint.RemoveTagged();
 
-    // If more than one point was constrained coincident with hpt, then
-    // those two points were implicitly coincident with each other. By
-    // deleting hpt (and all constraints that mention it), we will delete
-    // that relationship. So put it back here now.
-    for(int i = 1; i < ld.n; i++) {
-        Constraint::ConstrainCoincident(ld[i-1], ld[i]);
+    // If more than one surviving point ended up in a coincidence class,
+    // then those points were implicitly coincident with each other. By
+    // deleting the points that joined them (and all constraints that
+    // mention those), we will delete that relationship. So put it back
+    // here now, as a chain through each class.
+    std::vector<Constraint> cs;
+    std::unordered_map<uint32_t, hEntity> last;
+    for(hEntity hpt : survivors) {
+        uint32_t root = find(hpt.v);
+        auto it = last.find(root);
+        if(it == last.end()) {
+            last.emplace(root, hpt);
+            continue;
+        }
+
+        Constraint c = {};
+        c.group = SS.GW.activeGroup;
+        c.workplane = SS.GW.ActiveWorkplane();
+        c.type = Constraint::Type::POINTS_COINCIDENT;
+        c.ptA = it->second;
+        c.ptB = hpt;
+        cs.push_back(c);
+        it->second = hpt;
+    }
+    if(!cs.empty()) {
+        Constraint::AddConstraints(&cs);
     }
-    ld.Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -228,16 +324,18 @@ void GraphicsWindow::ParametricCurve::ConstrainPointIfCoincident(hEntity hpt) {
     Vector ev, ptv;
     ptv = pt->PointGetNum();
 
-    for(Entity &e : SK.entity) {
-        if(e.h == pt->h) continue;
-        if(!e.IsPoint()) continue;
-        if(e.group != pt->group) continue;
-        if(e.workplane != pt->workplane) continue;
+    // Vector::Equals compares each coordinate, so look within the diagonal.
+    std::vector<hEntity> near;
+    SK.pointIndex.PointsNear(pt->group, ptv, LENGTH_EPS * sqrt(3.0), &near);
+    for(hEntity he : near) {
+        Entity *e = SK.GetEntity(he);
+        if(e->h == pt->h) continue;
+        if(e->workplane != pt->workplane) continue;
 
-        ev = e.PointGetNum();
+        ev = e->PointGetNum();
         if(!ev.Equals(ptv)) continue;
 
-        Constraint::ConstrainCoincident(hpt, e.h);
+        Constraint::ConstrainCoincident(hpt, e->h);
         break;
     }
 }
@@ -28,6 +28,9 @@ Common options:
         For non-export commands, the unit is %%, and the default is 1.0 %%.
     -b, --bg-color <on|off>
         Whether to export the background colour in vector formats. Defaults to off.
+    --stats
+        After processing each file, prints how much memory was allocated
+        from the temporary arena, and its high-water mark.
 
 Commands:
     version
@@ -51,6 +54,9 @@ Commands:
         Reloads all imported files, regenerates the sketch, and saves it.
         Note that, although this is not an export command, it uses absolute
         chord tolerance, and can be used to prepare assemblies for export.
+    profile --output <pattern> [--chord-tol <tolerance>]
+        Regenerates the sketch, and writes how long each group took to solve
+        and to generate its mesh, broken down by phase, as JSON.
 )");
 
     auto FormatListFromFileFilters = [](const std::vector<Platform::FileFilter> &filters) {
@@ -176,6 +182,14 @@ static bool RunCommand(const std::vector<std::string> args) {
         } else return false;
     };
 
+    bool showStats = false;
+    auto ParseStats = [&](size_t &argn) {
+        if(args[argn] == "--stats") {
+            showStats = true;
+            return true;
+        } else return false;
+    };
+
     unsigned width = 0, height = 0;
     if(args[1] == "version") {
         fprintf(stderr, "SolveSpace version %s \n\n", PACKAGE_VERSION);
@@ -192,6 +206,7 @@ static bool RunCommand(const std::vector<std::string> args) {
 
         for(size_t argn = 2; argn < args.size(); argn++) {
             if(!(ParseInputFile(argn) ||
+                 ParseStats(argn) ||
                  ParseOutputPattern(argn) ||
                  ParseViewDirection(argn) ||
                  ParseChordTolerance(argn) ||
@@ -244,6 +259,7 @@ static bool RunCommand(const std::vector<std::string> args) {
     } else if(args[1] == "export-view") {
         for(size_t argn = 2; argn < args.size(); argn++) {
             if(!(ParseInputFile(argn) ||
+                 ParseStats(argn) ||
                  ParseOutputPattern(argn) ||
                  ParseViewDirection(argn) ||
                  ParseChordTolerance(argn) ||
@@ -269,6 +285,7 @@ static bool RunCommand(const std::vector<std::string> args) {
     } else if(args[1] == "export-wireframe") {
         for(size_t argn = 2; argn < args.size(); argn++) {
             if(!(ParseInputFile(argn) ||
+                 ParseStats(argn) ||
                  ParseOutputPattern(argn) ||
                  ParseChordTolerance(argn))) {
                 fprintf(stderr, "Unrecognized option '%s'.\n", args[argn].c_str());
@@ -284,6 +301,7 @@ static bool RunCommand(const std::vector<std::string> args) {
     } else if(args[1] == "export-mesh") {
         for(size_t argn = 2; argn < args.size(); argn++) {
             if(!(ParseInputFile(argn) ||
+                 ParseStats(argn) ||
                  ParseOutputPattern(argn) ||
                  ParseChordTolerance(argn))) {
                 fprintf(stderr, "Unrecognized option '%s'.\n", args[argn].c_str());
@@ -299,6 +317,7 @@ static bool RunCommand(const std::vector<std::string> args) {
     } else if(args[1] == "export-surfaces") {
         for(size_t argn = 2; argn < args.size(); argn++) {
             if(!(ParseInputFile(argn) ||
+                 ParseStats(argn) ||
                  ParseOutputPattern(argn))) {
                 fprintf(stderr, "Unrecognized option '%s'.\n", args[argn].c_str());
                 return false;
@@ -312,6 +331,7 @@ static bool RunCommand(const std::vector<std::string> args) {
     } else if(args[1] == "regenerate") {
         for(size_t argn = 2; argn < args.size(); argn++) {
             if(!(ParseInputFile(argn) ||
+                 ParseStats(argn) ||
                  ParseChordTolerance(argn))) {
                 fprintf(stderr, "Unrecognized option '%s'.\n", args[argn].c_str());
                 return false;
@@ -326,6 +346,24 @@ static bool RunCommand(const std::vector<std::string> args) {
 
             SS.SaveToFile(output);
         };
+    } else if(args[1] == "profile") {
+        for(size_t argn = 2; argn < args.size(); argn++) {
+            if(!(ParseInputFile(argn) ||
+                 ParseStats(argn) ||
+                 ParseOutputPattern(argn) ||
+                 ParseChordTolerance(argn))) {
+                fprintf(stderr, "Unrecognized option '%s'.\n", args[argn].c_str());
+                return false;
+            }
+        }
+
+        runner = [&](const Platform::Path &output) {
+            SS.exportChordTol = chordTol;
+            SS.exportMode = true;
+
+            SS.GenerateAll(SolveSpaceUI::Generate::ALL);
+            SS.ExportProfileTo(output);
+        };
     } else {
         fprintf(stderr, "Unrecognized command '%s'.\n", args[1].c_str());
         return false;
@@ -361,6 +399,7 @@ static bool RunCommand(const std::vector<std::string> args) {
         }
         Platform::Path absOutputFile = outputFile.Expand(/*fromCurrentDirectory=*/true);
 
+        Platform::TemporaryStatsScope tempStats;
         SS.Init();
         if(!SS.LoadFromFile(absInputFile)) {
             fprintf(stderr, "Cannot load '%s'!\n", inputFile.raw.c_str());
@@ -372,6 +411,13 @@ static bool RunCommand(const std::vector<std::string> args) {
         SS.Clear();
 
         fprintf(stderr, "Written '%s'.\n", outputFile.raw.c_str());
+        if(showStats) {
+            Platform::TemporaryStats stats = tempStats.Get();
+            fprintf(stderr, "Temporary arena: %zu allocations, %zu bytes, "
+                            "peak %zu bytes, freed %zu times.\n",
+                    stats.totalAllocations, stats.totalBytes,
+                    stats.peakBytes, stats.frees);
+        }
     }
 
     return true;
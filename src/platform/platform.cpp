@@ -694,21 +694,104 @@ struct MimallocHeap {
     }
 };
 
+// Small allocations are carved out of chunks taken from the heap by bumping
+// a pointer; the chunks themselves, and the large allocations, go away
+// together with the heap.
+struct TemporaryChunk {
+    uint8_t *next = NULL;
+    uint8_t *end  = NULL;
+};
+
+static const size_t TEMP_ALIGN      = 16;
+static const size_t TEMP_CHUNK_SIZE = 64 * 1024;
+static const size_t TEMP_LARGE_SIZE = TEMP_CHUNK_SIZE / 4;
+
 static thread_local MimallocHeap TempArena;
+static thread_local TemporaryChunk TempChunk;
+static thread_local TemporaryStats TempStats;
 
-void *AllocTemporary(size_t size) {
+static void *AllocTemporaryFromHeap(size_t size) {
     if(TempArena.heap == NULL) {
         TempArena.heap = mi_heap_new();
         ssassert(TempArena.heap != NULL, "out of memory");
     }
-    void *ptr = mi_heap_zalloc(TempArena.heap, size);
+    void *ptr = mi_heap_malloc_aligned(TempArena.heap, size, TEMP_ALIGN);
     ssassert(ptr != NULL, "out of memory");
+    TempStats.reservedBytes += size;
+    return ptr;
+}
+
+void *AllocTemporaryUninitialized(size_t size) {
+    TemporaryStats &stats = TempStats;
+    stats.bytes += size;
+    stats.allocations++;
+    stats.totalBytes += size;
+    stats.totalAllocations++;
+    if(stats.bytes > stats.peakBytes)
+        stats.peakBytes = stats.bytes;
+
+    // Even an empty allocation must return a distinct pointer.
+    size_t rounded = (std::max(size, (size_t)1) + TEMP_ALIGN - 1) & ~(TEMP_ALIGN - 1);
+    TemporaryChunk &chunk = TempChunk;
+    if(rounded <= (size_t)(chunk.end - chunk.next)) {
+        void *ptr = chunk.next;
+        chunk.next += rounded;
+        return ptr;
+    }
+
+    if(rounded > TEMP_LARGE_SIZE) {
+        // Not worth wasting the rest of the current chunk on.
+        return AllocTemporaryFromHeap(rounded);
+    }
+    chunk.next = (uint8_t *)AllocTemporaryFromHeap(TEMP_CHUNK_SIZE);
+    chunk.end  = chunk.next + TEMP_CHUNK_SIZE;
+    void *ptr = chunk.next;
+    chunk.next += rounded;
+    return ptr;
+}
+
+void *AllocTemporary(size_t size) {
+    void *ptr = AllocTemporaryUninitialized(size);
+    memset(ptr, 0, size);
     return ptr;
 }
 
 void FreeAllTemporary() {
     MimallocHeap temp;
     std::swap(TempArena.heap, temp.heap);
+    TempChunk = {};
+
+    TempStats.bytes = 0;
+    TempStats.allocations = 0;
+    TempStats.reservedBytes = 0;
+    TempStats.frees++;
+}
+
+TemporaryStats GetTemporaryStats() {
+    return TempStats;
+}
+
+TemporaryStatsScope::TemporaryStatsScope() {
+    start = TempStats;
+    outerPeakBytes = TempStats.peakBytes;
+    TempStats.peakBytes = TempStats.bytes;
+}
+
+TemporaryStatsScope::~TemporaryStatsScope() {
+    if(TempStats.peakBytes < outerPeakBytes)
+        TempStats.peakBytes = outerPeakBytes;
+}
+
+TemporaryStats TemporaryStatsScope::Get() const {
+    TemporaryStats stats = {};
+    stats.bytes            = TempStats.bytes;
+    stats.allocations      = TempStats.allocations;
+    stats.reservedBytes    = TempStats.reservedBytes;
+    stats.peakBytes        = TempStats.peakBytes;
+    stats.totalBytes       = TempStats.totalBytes - start.totalBytes;
+    stats.totalAllocations = TempStats.totalAllocations - start.totalAllocations;
+    stats.frees            = TempStats.frees - start.frees;
+    return stats;
 }
 
 }
@@ -76,10 +76,40 @@ std::vector<std::string> InitCli(int argc, char **argv);
 // Debug print function.
 void DebugPrint(const char *fmt, ...);
 
-// Temporary arena functions.
+// Temporary arena functions. The memory is zeroed unless requested otherwise,
+// and is aligned to 16 bytes.
 void *AllocTemporary(size_t size);
+void *AllocTemporaryUninitialized(size_t size);
 void FreeAllTemporary();
 
+// Temporary arena statistics; these are kept separately for each thread,
+// since so is the arena itself.
+struct TemporaryStats {
+    size_t bytes;            // live, i.e. allocated since the arena was last freed
+    size_t allocations;
+    size_t reservedBytes;    // live, taken from the system to back the above
+    size_t peakBytes;        // high-water mark of bytes
+    size_t totalBytes;       // allocated since the thread started
+    size_t totalAllocations;
+    size_t frees;            // calls to FreeAllTemporary
+};
+
+TemporaryStats GetTemporaryStats();
+
+// Measures the use of the temporary arena over its lifetime; the peak is
+// that reached while the scope is active.
+class TemporaryStatsScope {
+public:
+    TemporaryStatsScope();
+    ~TemporaryStatsScope();
+
+    TemporaryStats Get() const;
+
+private:
+    TemporaryStats start;
+    size_t outerPeakBytes;
+};
+
 }
 
 #endif
@@ -304,13 +304,25 @@ int SEdgeList::AnyEdgeCrossings(Vector a, Vector b, Vector *ppi, SPointList *spl
 
 //-----------------------------------------------------------------------------
 // Returns true if the intersecting edge list contains an edge that shares
-// an endpoint with one of our edges.
+// an endpoint with one of our edges. The test is symmetric, so we index
+// whichever list is longer by endpoint and look up the edges of the other.
 //-----------------------------------------------------------------------------
 bool SEdgeList::ContainsEdgeFrom(const SEdgeList *sel) const {
-    for(const SEdge *se = l.First(); se; se = l.NextAfter(se)) {
-        if(sel->ContainsEdge(se)) return true;
+    const SEdgeList *indexed = (sel->l.n >= l.n) ? sel : this,
+                    *queried = (sel->l.n >= l.n) ? this : sel;
+    if(queried->l.IsEmpty()) return false;
+
+    SEdgeAdjacency adj = {};
+    adj.Build(indexed);
+    bool found = false;
+    for(const SEdge *se = queried->l.First(); se; se = queried->l.NextAfter(se)) {
+        if(indexed->ContainsEdge(se, &adj)) {
+            found = true;
+            break;
+        }
     }
-    return false;
+    adj.Clear();
+    return found;
 }
 bool SEdgeList::ContainsEdge(const SEdge *set) const {
     for(const SEdge *se = l.First(); se; se = l.NextAfter(se)) {
@@ -319,6 +331,15 @@ bool SEdgeList::ContainsEdge(const SEdge *set) const {
     }
     return false;
 }
+bool SEdgeList::ContainsEdge(const SEdge *set, const SEdgeAdjacency *adj) const {
+    if(adj->starts.IndexForPoint(set->a, [&](int i) {
+        return (l[i].b).Equals(set->b);
+    }) >= 0) return true;
+    if(adj->starts.IndexForPoint(set->b, [&](int i) {
+        return (l[i].b).Equals(set->a);
+    }) >= 0) return true;
+    return false;
+}
 
 //-----------------------------------------------------------------------------
 // Remove unnecessary edges:
@@ -326,25 +347,38 @@ bool SEdgeList::ContainsEdge(const SEdge *set) const {
 //     if both=true, remove both
 //     else remove only one.
 // - if two are parallel then remove one.
+// This is the same as comparing every pair of edges i < j, but we find the
+// other edge of each pair through an index on the start points. An edge is
+// removed if an earlier edge is parallel or anti-parallel to it, or (if
+// both=true) if any other edge is anti-parallel to it.
 //-----------------------------------------------------------------------------
 void SEdgeList::CullExtraneousEdges(bool both) {
-    l.ClearTags();
-    for(int i = 0; i < l.n; i++) {
-        SEdge *se = &(l[i]);
-        for(int j = i + 1; j < l.n; j++) {
-            SEdge *set = &(l[j]);
-            if((set->a).Equals(se->a) && (set->b).Equals(se->b)) {
-                // Two parallel edges exist; so keep only the first one.
-                set->tag = 1;
-            }
-            if((set->a).Equals(se->b) && (set->b).Equals(se->a)) {
-                // Two anti-parallel edges exist; if both=true, keep neither,
-                // otherwise keep only one.
-                if (both) se->tag = 1;
-                set->tag = 1;
-            }
+    SEdgeAdjacency adj = {};
+    adj.Build(this);
+
+    std::vector<bool> cull(l.n, false);
+    for(int k = 0; k < l.n; k++) {
+        const SEdge *se = &(l[k]);
+        // Two parallel edges exist; so keep only the first one.
+        if(adj.starts.IndexForPoint(se->a, [&](int i) {
+            return i < k && (l[i].b).Equals(se->b);
+        }) >= 0) {
+            cull[k] = true;
+            continue;
+        }
+        // Two anti-parallel edges exist; if both=true, keep neither,
+        // otherwise keep only one.
+        if(adj.starts.IndexForPoint(se->b, [&](int i) {
+            return i != k && (both || i < k) && (l[i].b).Equals(se->a);
+        }) >= 0) {
+            cull[k] = true;
         }
     }
+    adj.Clear();
+
+    for(int k = 0; k < l.n; k++) {
+        l[k].tag = cull[k] ? 1 : 0;
+    }
     l.RemoveTagged();
 }
 
@@ -549,6 +583,98 @@ void SPointList::Add(Vector pt) {
     l.Add(&p);
 }
 
+//-----------------------------------------------------------------------------
+// A spatial hash of points, which gives the same answers as a linear search
+// with Vector::Equals(). The cells are tol on a side, so points within tol
+// in every coordinate are never more than one cell apart.
+//-----------------------------------------------------------------------------
+size_t SPointIndex::CellHash::operator()(const Cell &c) const {
+    uint64_t h = (uint64_t)c.x * 0x9E3779B97F4A7C15ull;
+    h ^= (uint64_t)c.y * 0xC2B2AE3D27D4EB4Full + (h << 6) + (h >> 2);
+    h ^= (uint64_t)c.z * 0x165667B19E3779F9ull + (h << 6) + (h >> 2);
+    return (size_t)h;
+}
+
+void SPointIndex::Clear() {
+    pts.clear();
+    next.clear();
+    head.clear();
+}
+
+SPointIndex::Cell SPointIndex::CellFor(Vector p) const {
+    return { (int64_t)floor(p.x / tol),
+             (int64_t)floor(p.y / tol),
+             (int64_t)floor(p.z / tol) };
+}
+
+int SPointIndex::Add(Vector p) {
+    int i = (int)pts.size();
+    pts.push_back(p);
+    auto it = head.find(CellFor(p));
+    if(it == head.end()) {
+        next.push_back(-1);
+        head[CellFor(p)] = i;
+    } else {
+        next.push_back(it->second);
+        it->second = i;
+    }
+    return i;
+}
+
+// Returns the lowest index of a point that Equals() p, or -1 if there's none;
+// the same as SPointList::IndexForPoint() over the points in order of Add().
+int SPointIndex::IndexForPoint(Vector p) const {
+    return IndexForPoint(p, [](int) { return true; });
+}
+
+// As above, but considering only the points that accept() does.
+int SPointIndex::IndexForPoint(Vector p, std::function<bool(int)> const &accept) const {
+    Cell c = CellFor(p);
+    int found = -1;
+    for(int64_t dx = -1; dx <= 1; dx++) {
+        for(int64_t dy = -1; dy <= 1; dy++) {
+            for(int64_t dz = -1; dz <= 1; dz++) {
+                auto it = head.find({ c.x + dx, c.y + dy, c.z + dz });
+                if(it == head.end()) continue;
+                for(int i = it->second; i >= 0; i = next[i]) {
+                    if(found >= 0 && i > found) continue;
+                    if(!pts[i].Equals(p, tol)) continue;
+                    if(!accept(i)) continue;
+                    found = i;
+                }
+            }
+        }
+    }
+    return found;
+}
+
+bool SPointIndex::ContainsPoint(Vector p) const {
+    return (IndexForPoint(p) >= 0);
+}
+
+void SEdgeAdjacency::Clear() {
+    starts.Clear();
+    finishes.Clear();
+}
+
+void SEdgeAdjacency::Build(const SEdgeList *sel) {
+    Clear();
+    for(const SEdge &se : sel->l) {
+        starts.Add(se.a);
+        finishes.Add(se.b);
+    }
+}
+
+// Returns the first untagged edge whose start Equals() p, or -1.
+int SEdgeAdjacency::UntaggedEdgeStartingAt(Vector p, const SEdgeList *sel) const {
+    return starts.IndexForPoint(p, [&](int i) { return sel->l[i].tag == 0; });
+}
+
+// Returns the first untagged edge whose finish Equals() p, or -1.
+int SEdgeAdjacency::UntaggedEdgeFinishingAt(Vector p, const SEdgeList *sel) const {
+    return finishes.IndexForPoint(p, [&](int i) { return sel->l[i].tag == 0; });
+}
+
 void SContour::AddPoint(Vector p) {
     SPoint sp;
     sp.tag = 0;
@@ -14,6 +14,7 @@ class SContour;
 class SMesh;
 class SBsp3;
 class SOutlineList;
+class SEdgeAdjacency;
 
 enum class EarType : uint32_t {
     UNKNOWN = 0,
@@ -58,6 +59,7 @@ public:
         Vector *pi=NULL, SPointList *spl=NULL) const;
     bool ContainsEdgeFrom(const SEdgeList *sel) const;
     bool ContainsEdge(const SEdge *se) const;
+    bool ContainsEdge(const SEdge *se, const SEdgeAdjacency *adj) const;
     void CullExtraneousEdges(bool both=true);
     void MergeCollinearSegments(Vector a, Vector b);
 };
@@ -112,6 +114,51 @@ public:
     void Add(Vector pt);
 };
 
+// A spatial hash over points, with cells as large as the tolerance; any two
+// points that are Equals() lie in the same or in adjacent cells, so a lookup
+// only has to probe the 27 cells around the query point.
+class SPointIndex {
+public:
+    struct Cell {
+        int64_t x, y, z;
+
+        bool operator==(const Cell &c) const {
+            return x == c.x && y == c.y && z == c.z;
+        }
+    };
+    struct CellHash {
+        size_t operator()(const Cell &c) const;
+    };
+
+    double                                  tol = LENGTH_EPS;
+    std::vector<Vector>                     pts;
+    // Points in the same cell form a singly linked list through next, in
+    // decreasing order of index.
+    std::vector<int>                        next;
+    std::unordered_map<Cell, int, CellHash> head;
+
+    void Clear();
+    Cell CellFor(Vector p) const;
+    int Add(Vector p);
+    int IndexForPoint(Vector p) const;
+    int IndexForPoint(Vector p, std::function<bool(int)> const &accept) const;
+    bool ContainsPoint(Vector p) const;
+};
+
+// The edges of an SEdgeList indexed by their endpoints, so that we can find
+// the edges that start or finish at a point without scanning the list. The
+// indices are into the list as it was when we were built.
+class SEdgeAdjacency {
+public:
+    SPointIndex starts;
+    SPointIndex finishes;
+
+    void Clear();
+    void Build(const SEdgeList *sel);
+    int UntaggedEdgeStartingAt(Vector p, const SEdgeList *sel) const;
+    int UntaggedEdgeFinishingAt(Vector p, const SEdgeList *sel) const;
+};
+
 class SContour {
 public:
     int             tag;
@@ -356,7 +403,9 @@ public:
                               bool *inter, bool *leaky, int auxA = 0) const;
     void MakeOutlinesInto(SOutlineList *sel, EdgeKind tagKind) const;
 
-    void OcclusionTestLine(SEdge orig, SEdgeList *sel, int cnt) const;
+    void ListTrianglesAlong(SEdge orig, std::vector<STriangle *> *tl,
+                            std::unordered_set<const STriangle *> *seen) const;
+    void OcclusionTestLine(SEdge orig, SEdgeList *sel) const;
     void SplitLinesAgainstTriangle(SEdgeList *sel, STriangle *tr) const;
 
     void SnapToMesh(SMesh *m);
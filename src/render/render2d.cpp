@@ -263,9 +263,7 @@ void SurfaceRenderer::CullOccludedStrokes() {
 
     // Remove hidden lines (on NORMAL layers), or remove visible lines (on OCCLUDED layers).
     SKdNode *root = SKdNode::From(&mesh);
-    root->ClearTags();
 
-    int cnt = 1234;
     for(auto &eit : edges) {
         hStroke hcs = eit.first;
         SEdgeList &el = eit.second;
@@ -278,7 +276,7 @@ void SurfaceRenderer::CullOccludedStrokes() {
         for(const SEdge &e : el.l) {
             SEdgeList oel = {};
             oel.AddEdge(e.a, e.b);
-            root->OcclusionTestLine(e, &oel, cnt);
+            root->OcclusionTestLine(e, &oel);
 
             if(stroke->layer == Layer::OCCLUDED) {
                 for(SEdge &oe : oel.l) {
@@ -293,7 +291,6 @@ void SurfaceRenderer::CullOccludedStrokes() {
             }
 
             oel.Clear();
-            cnt++;
         }
 
         el.l.Clear();
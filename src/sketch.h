@@ -194,6 +194,15 @@ public:
         List<hConstraint>   remove;
     } solved;
 
+    // How long this group took, the last time it was regenerated.
+    struct {
+        SolveStats          solve;
+        double              solveMs;    // in all, including the above
+        double              meshMs;     // this group's own shell or mesh
+        double              booleanMs;  // combining that with the others
+        bool                stale;      // not regenerated last time, so older
+    } profile;
+
     enum class Subtype : uint32_t {
         // For drawings in 2d
         WORKPLANE_BY_POINT_ORTHO   = 6000,
@@ -250,6 +259,18 @@ public:
 
     EntityMap remap;
 
+    // The numerical transform of each copy that a step and repeat or linked
+    // group makes, by the number of times that it was applied; the copied
+    // entities look these up instead of each rebuilding them from the params.
+    struct CopyTransform {
+        bool        valid;
+        Vector      offset;
+        Vector      displace;
+        Quaternion  q;
+    };
+    std::vector<CopyTransform>  copyTransforms;
+    int                         copyTransformFirst;
+
     Platform::Path linkFile;
     SMesh       impMesh;
     SShell      impShell;
@@ -302,6 +323,8 @@ public:
     size_t GetNumConstraints();
     Vector ExtrusionGetVector();
     void ExtrusionForceVectorTo(const Vector &v);
+    const CopyTransform *GetCopyTransform(int timesApplied);
+    void InvalidateCopyTransforms() { copyTransforms.clear(); }
 
     // Assembling the curves into loops, and into a piecewise linear polygon
     // at the same time.
@@ -454,6 +477,8 @@ public:
 
     Quaternion GetAxisAngleQuaternion(int param0) const;
     ExprQuaternion GetAxisAngleQuaternionExprs(int param0) const;
+    const Group::CopyTransform *GetCopyTransform(hParam hp, int groupParam) const;
+    void InvalidateCopyTransforms() const;
 
     bool IsCircle() const;
     Expr *CircleGetRadiusExpr() const;
@@ -780,6 +805,7 @@ public:
     std::string DescriptionString() const;
 
     static hConstraint AddConstraint(Constraint *c, bool rememberForUndo = true);
+    static void AddConstraints(std::vector<Constraint> *cs);
     static void MenuConstrain(Command id);
     static void DeleteAllConstraintsFor(Constraint::Type type, hEntity entityA, hEntity ptA);
 
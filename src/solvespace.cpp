@@ -53,6 +53,11 @@ void SolveSpaceUI::Init() {
     exportMaxSegments = settings->ThawInt("ExportMaxSegments", 64);
     // Timeout value for finding redundant constrains (ms)
     timeoutRedundantConstr = settings->ThawInt("TimeoutRedundantConstraints", 1000);
+    // Method for the nonlinear solve; anything we don't know means Newton
+    solverAlgorithm =
+        (settings->ThawInt("SolverAlgorithm", (uint32_t)System::Algorithm::NEWTON) ==
+            (uint32_t)System::Algorithm::LEVENBERG_MARQUARDT) ?
+        System::Algorithm::LEVENBERG_MARQUARDT : System::Algorithm::NEWTON;
     // View units
     viewUnits = (Unit)settings->ThawInt("ViewUnits", (uint32_t)Unit::MM);
     // Number of digits after the decimal point
@@ -235,6 +240,8 @@ void SolveSpaceUI::Exit() {
     settings->FreezeInt("ExportMaxSegments", (uint32_t)exportMaxSegments);
     // Timeout for finding which constraints to fix Jacobian
     settings->FreezeInt("TimeoutRedundantConstraints", (uint32_t)timeoutRedundantConstr);
+    // Method for the nonlinear solve
+    settings->FreezeInt("SolverAlgorithm", (uint32_t)solverAlgorithm);
     // View units
     settings->FreezeInt("ViewUnits", (uint32_t)viewUnits);
     // Number of digits after the decimal point
@@ -433,6 +440,17 @@ int SolveSpaceUI::GetMaxSegments() {
     if(exportMode) return exportMaxSegments;
     return maxSegments;
 }
+
+SKernelContext SKernelContext::FromSettings() {
+    SKernelContext ctx = {};
+    ctx.chordTol    = SS.ChordTolMm();
+    ctx.maxSegments = SS.GetMaxSegments();
+    ctx.nakedEdges  = &SS.nakedEdges;
+    ctx.faceExists  = [](uint32_t face) {
+        return SK.entity.FindByIdNoOops(hEntity{face}) != NULL;
+    };
+    return ctx;
+}
 int SolveSpaceUI::UnitDigitsAfterDecimal() {
     return (viewUnits == Unit::INCHES) ? afterDecimalInch : afterDecimalMm;
 }
@@ -1047,6 +1065,120 @@ void Sketch::Clear() {
     style.Clear();
     entity.Clear();
     param.Clear();
+    pointIndex.Clear();
+}
+
+void SketchPointIndex::Clear() {
+    groups.clear();
+}
+
+// Index the points of the given groups again, from where their entities are
+// now; called once they're solved.
+void SketchPointIndex::Build(const std::vector<hGroup> &hgs) {
+    std::unordered_map<uint32_t, Points *> building;
+    for(hGroup hg : hgs) {
+        Points *pts = &groups[hg.v];
+        *pts = {};
+        building[hg.v] = pts;
+    }
+    if(building.empty()) return;
+
+    for(const Entity &e : SK.entity) {
+        if(!e.IsPoint()) continue;
+        auto it = building.find(e.group.v);
+        if(it == building.end()) continue;
+
+        Points *pts = it->second;
+        Vector p = e.PointGetNum();
+        pts->slot[e.h.v] = (int)pts->points.size();
+        pts->points.push_back(e.h);
+        pts->pos.push_back(p);
+        pts->moved.push_back(false);
+        pts->bvh.Add(BBox::From(p, p));
+    }
+    for(auto &it : building) {
+        it.second->bvh.Build();
+    }
+}
+
+// Record that a point was forced to p, without indexing the rest of its group
+// again; a point that wasn't indexed yet is added.
+void SketchPointIndex::PointMoved(hGroup hg, hEntity he, Vector p) {
+    Points *pts = &groups[hg.v];
+    auto it = pts->slot.find(he.v);
+    int i;
+    if(it == pts->slot.end()) {
+        i = (int)pts->points.size();
+        pts->slot[he.v] = i;
+        pts->points.push_back(he);
+        pts->pos.push_back(p);
+        pts->moved.push_back(false);
+    } else {
+        i = it->second;
+        pts->pos[i] = p;
+    }
+    if(!pts->moved[i]) {
+        pts->moved[i] = true;
+        pts->movedList.push_back(i);
+    }
+}
+
+// Finds the points of a group whose position passes the given test, in the
+// order that they appear in the sketch. The test must pass for a box if it
+// passes for any point inside that box.
+void SketchPointIndex::FindPoints(hGroup hg,
+                                  const std::function<bool(const BBox &)> &overlaps,
+                                  std::vector<hEntity> *found) const {
+    found->clear();
+    auto it = groups.find(hg.v);
+    if(it == groups.end()) return;
+    const Points &pts = it->second;
+
+    std::vector<int> ids;
+    pts.bvh.FindOverlapping(overlaps, &ids);
+    for(int i : ids) {
+        if(pts.moved[i]) continue;
+        found->push_back(pts.points[i]);
+    }
+    for(int i : pts.movedList) {
+        if(!overlaps(BBox::From(pts.pos[i], pts.pos[i]))) continue;
+        found->push_back(pts.points[i]);
+    }
+    std::sort(found->begin(), found->end(),
+              [](hEntity a, hEntity b) { return a.v < b.v; });
+}
+
+// Finds the points of a group within distance r of p.
+void SketchPointIndex::PointsNear(hGroup hg, Vector p, double r,
+                                  std::vector<hEntity> *found) const {
+    Vector d = Vector::From(r, r, r);
+    BBox query = BBox::From(p.Minus(d), p.Plus(d));
+    std::vector<hEntity> inBox;
+    FindPoints(hg, [&](const BBox &b) { return b.Overlaps(query); }, &inBox);
+
+    found->clear();
+    for(hEntity he : inBox) {
+        Entity *e = SK.entity.FindByIdNoOops(he);
+        if(e == NULL) continue;
+        if(e->PointGetNum().Minus(p).Magnitude() > r) continue;
+        found->push_back(he);
+    }
+}
+
+hEntity SketchPointIndex::NearestPoint(hGroup hg, Vector p, double r) const {
+    std::vector<hEntity> found;
+    PointsNear(hg, p, r, &found);
+
+    hEntity best = Entity::NO_ENTITY;
+    double dmin = VERY_POSITIVE;
+    for(hEntity he : found) {
+        double d = SK.GetEntity(he)->PointGetNum().Minus(p).Magnitude();
+        if(d < dmin) {
+            dmin = d;
+            best = he;
+        }
+    }
+    return best;
 }
 
 BBox Sketch::CalculateEntityBBox(bool includingInvisible) {
@@ -91,6 +91,8 @@ void AssertFailure(const char *file, unsigned line, const char *function,
 __attribute__((__format__ (__printf__, 1, 2)))
 #endif
 std::string ssprintf(const char *fmt, ...);
+void vssappendf(std::string *out, const char *fmt, va_list va);
+void AppendFixed(std::string *out, double v, int decimals);
 
 inline bool IsReasonable(double x) {
     return std::isnan(x) || x > 1e11 || x < -1e11;
@@ -127,6 +129,7 @@ static constexpr double VERY_NEGATIVE = -1e10;
 #include "resource.h"
 
 using Platform::AllocTemporary;
+using Platform::AllocTemporaryUninitialized;
 using Platform::FreeAllTemporary;
 
 class Expr;
@@ -166,6 +169,24 @@ enum class SolveResult : uint32_t {
     TOO_MANY_UNKNOWNS        = 20
 };
 
+// What a call to System::Solve() did, and how long each part of it took,
+// in milliseconds.
+struct SolveStats {
+    double  writeEquationsMs;
+    double  substitutionMs;
+    double  blocksMs;
+    double  jacobianMs;
+    double  rankMs;
+    double  solveMs;
+    double  findBadMs;
+
+    int     equations;      // as written, before any were eliminated
+    int     substituted;    // params eliminated by substitution
+    int     blocks;         // solved on their own, before the main system
+    int     rows, columns;  // of the main system's Jacobian
+    int     iterations;     // of the nonlinear solver, including blocks
+};
+
 
 #include "sketch.h"
 #include "ui.h"
@@ -203,6 +224,7 @@ void MakeMatrix(double *mat, double a11, double a12, double a13, double a14,
 void MultMatrix(double *mata, double *matb, double *matr);
 
 int64_t GetMilliseconds();
+double GetMillisecondsPrecise();
 void Message(const char *fmt, ...);
 void MessageAndRun(std::function<void()> onDismiss, const char *fmt, ...);
 void Error(const char *fmt, ...);
@@ -219,11 +241,20 @@ public:
     // we should put as close as possible to their initial positions.
     List<hParam>                    dragged;
 
+    // The params eliminated by SolveBySubstitution, and what replaced them;
+    // and the equations that it found to be redundant, which must be left
+    // for the rank test.
+    std::unordered_map<uint32_t, Expr::Substitution> substituted;
+    std::unordered_set<uint32_t>                     redundant;
+
+    SolveStats                      stats;
+
     enum {
         // In general, the tag indicates the subsys that a variable/equation
         // has been assigned to; these are exceptions for variables:
         VAR_SUBSTITUTED      = 10000,
         VAR_DOF_TEST         = 10001,
+        VAR_FIXED            = 10002,
         // and for equations:
         EQ_SUBSTITUTED       = 20000
     };
@@ -265,16 +296,30 @@ public:
     bool SolveLeastSquares();
 
     bool WriteJacobian(int tag);
+    bool WriteJacobian(const std::vector<Equation *> &eqs,
+                       const std::vector<hParam> &params);
     void EvalJacobian();
 
     void WriteEquationsExceptFor(hConstraint hc, Group *g);
     void FindWhichToRemoveToFixJacobian(Group *g, List<hConstraint> *bad,
                                         bool forceDofCheck);
     void SolveBySubstitution();
+    void SolveInBlocks();
 
     bool IsDragged(hParam p);
 
     bool NewtonSolve(int tag);
+    double EvalResiduals();
+    bool LevenbergMarquardtSolve(int tag);
+
+    // The method for the nonlinear solves; Levenberg-Marquardt only takes
+    // steps that reduce the residual.
+    enum class Algorithm : uint32_t {
+        NEWTON               = 0,
+        LEVENBERG_MARQUARDT  = 1
+    };
+    Algorithm                       algorithm;
+    bool SolveNonlinear(int tag);
 
     void MarkParamsFree(bool findFree);
     int CalculateDof();
@@ -300,14 +345,22 @@ public:
     void WriteProductHeader();
     int ExportCurve(SBezier *sb);
     int ExportCurveLoop(SBezierLoop *loop, bool inner);
-    void ExportSurface(SSurface *ss, SBezierList *sbl);
+    static void FindTrimLoops(SSurface *ss, SBezierList *sbl, SBezierLoopSetSet *sblss);
+    static int IdsForSurface(SSurface *ss, SBezierLoopSetSet *sblss);
+    void ExportSurface(SSurface *ss, SBezierLoopSetSet *sblss);
     void WriteWireframe();
     void WriteFooter();
 
+    void Write(const char *fmt, ...);
+    void WriteNumber(double v);
+    void WritePoint(int pid, Vector p);
+    void Flush();
+
     List<int> curves;
     List<int> advancedFaces;
     FILE *f;
     int id;
+    std::string buf;
 };
 
 class VectorFileWriter {
@@ -319,9 +372,17 @@ public:
     FILE *f;
     Platform::Path filename;
     Vector ptMin, ptMax;
+    std::string buf;
 
     static double MmToPts(double mm);
 
+    void Write(const char *fmt, ...);
+    void WriteNumber(double v);
+    void WriteXy(double x, double y, char sep);
+    void WriteRgb(RgbaColor rgb);
+    void Flush();
+    uint32_t Tell();
+
     static VectorFileWriter *ForFile(const Platform::Path &filename);
 
     void SetModelviewProjection(const Vector &u, const Vector &v, const Vector &n,
@@ -345,6 +406,10 @@ public:
     virtual void FinishAndCloseFile() = 0;
     virtual bool HasCanvasSize() const = 0;
     virtual bool CanOutputMesh() const = 0;
+    virtual bool CanOutputFills() const = 0;
+    // Whether closed paths must come out as oriented loops, with their holes
+    // grouped under them; anything that fills them does need that.
+    virtual bool NeedsOrientedLoops() const { return CanOutputFills(); }
 };
 class DxfFileWriter : public VectorFileWriter {
 public:
@@ -370,6 +435,7 @@ public:
     void FinishAndCloseFile() override;
     bool HasCanvasSize() const override { return false; }
     bool CanOutputMesh() const override { return false; }
+    bool CanOutputFills() const override { return false; }
     bool NeedToOutput(Constraint *c);
 };
 class EpsFileWriter : public VectorFileWriter {
@@ -388,6 +454,7 @@ public:
     void FinishAndCloseFile() override;
     bool HasCanvasSize() const override { return true; }
     bool CanOutputMesh() const override { return true; }
+    bool CanOutputFills() const override { return true; }
 };
 class PdfFileWriter : public VectorFileWriter {
 public:
@@ -407,6 +474,7 @@ public:
     void FinishAndCloseFile() override;
     bool HasCanvasSize() const override { return true; }
     bool CanOutputMesh() const override { return true; }
+    bool CanOutputFills() const override { return true; }
 };
 class SvgFileWriter : public VectorFileWriter {
 public:
@@ -424,6 +492,7 @@ public:
     void FinishAndCloseFile() override;
     bool HasCanvasSize() const override { return true; }
     bool CanOutputMesh() const override { return true; }
+    bool CanOutputFills() const override { return true; }
 };
 class HpglFileWriter : public VectorFileWriter {
 public:
@@ -439,6 +508,7 @@ public:
     void FinishAndCloseFile() override;
     bool HasCanvasSize() const override { return false; }
     bool CanOutputMesh() const override { return false; }
+    bool CanOutputFills() const override { return false; }
 };
 class Step2dFileWriter : public VectorFileWriter {
     StepFileWriter sfw;
@@ -453,6 +523,7 @@ class Step2dFileWriter : public VectorFileWriter {
     void FinishAndCloseFile() override;
     bool HasCanvasSize() const override { return false; }
     bool CanOutputMesh() const override { return false; }
+    bool CanOutputFills() const override { return false; }
 };
 class GCodeFileWriter : public VectorFileWriter {
 public:
@@ -468,6 +539,37 @@ public:
     void FinishAndCloseFile() override;
     bool HasCanvasSize() const override { return false; }
     bool CanOutputMesh() const override { return false; }
+    bool CanOutputFills() const override { return false; }
+    // The direction of each closed contour decides between climb and
+    // conventional milling.
+    bool NeedsOrientedLoops() const override { return true; }
+};
+
+// The point entities of each group, with a bounding volume hierarchy over
+// their positions, to find the points near a location without going through
+// every entity. A group's points are indexed again after it's solved; a point
+// that's forced somewhere else before that is set aside from the hierarchy,
+// and checked on its own.
+class SketchPointIndex {
+public:
+    struct Points {
+        std::vector<hEntity>                points;
+        std::vector<Vector>                 pos;
+        std::vector<bool>                   moved;
+        std::vector<int>                    movedList;
+        std::unordered_map<uint32_t, int>   slot;
+        SBvh                                bvh;
+    };
+
+    std::unordered_map<uint32_t, Points>    groups;
+
+    void Clear();
+    void Build(const std::vector<hGroup> &hgs);
+    void PointMoved(hGroup hg, hEntity he, Vector p);
+    void FindPoints(hGroup hg, const std::function<bool(const BBox &)> &overlaps,
+                    std::vector<hEntity> *found) const;
+    void PointsNear(hGroup hg, Vector p, double r, std::vector<hEntity> *found) const;
+    hEntity NearestPoint(hGroup hg, Vector p, double r) const;
 };
 
 #ifdef LIBRARY
@@ -490,6 +592,8 @@ public:
     IdList<ENTITY,hEntity>          entity;
     IdList<Param,hParam>            param;
 
+    SketchPointIndex                pointIndex;
+
     inline CONSTRAINT *GetConstraint(hConstraint h)
         { return constraint.FindById(h); }
     inline ENTITY  *GetEntity (hEntity  h) { return entity. FindById(h); }
@@ -564,6 +668,7 @@ public:
     double   exportChordTol;
     int      exportMaxSegments;
     int      timeoutRedundantConstr; //milliseconds
+    System::Algorithm solverAlgorithm;
     double   cameraTangent;
     double   gridSpacing;
     double   exportScale;
@@ -690,6 +795,7 @@ public:
     void ExportMeshAsThreeJsTo(FILE *f, const Platform::Path &filename,
                                SMesh *sm, SOutlineList *sol);
     void ExportMeshAsVrmlTo(FILE *f, const Platform::Path &filename, SMesh *sm);
+    void ExportProfileTo(const Platform::Path &filename);
     void ExportViewOrWireframeTo(const Platform::Path &filename, bool exportWireframe);
     void ExportSectionTo(const Platform::Path &filename);
     void ExportWireframeCurves(SEdgeList *sel, SBezierList *sbl,
@@ -728,7 +834,19 @@ public:
         List<ClipboardRequest>  r;
         List<Constraint>        c;
 
+        // Where each old entity went: the index of its request in r, and
+        // the slot in that request (0 for the entity itself, 1+i for its
+        // point i). Requests are only ever appended to r, so this is kept
+        // up to date lazily.
+        struct EntitySlot {
+            int request;
+            int slot;
+        };
+        std::unordered_map<uint32_t, EntitySlot> entitySlots;
+        int                                      requestsIndexed;
+
         void Clear();
+        void IndexRequests();
         bool ContainsEntity(hEntity old);
         hEntity NewEntityFor(hEntity old);
     };
@@ -135,7 +135,7 @@ SCurve SCurve::MakeCopySplitAgainst(SShell *agnstA, SShell *agnstB,
                 if(c == SBspUv::Class::OUTSIDE) {
                     double d = VERY_POSITIVE;
                     if(pi->srf->bsp) d = pi->srf->bsp->MinimumDistanceToEdge(puv, pi->srf);
-                    if(d > SS.ChordTolMm()) {
+                    if(d > SKernelContext::Current()->chordTol) {
                         pi->tag = 1;
                         continue;
                     }
@@ -201,8 +201,10 @@ SCurve SCurve::MakeCopySplitAgainst(SShell *agnstA, SShell *agnstB,
 }
 
 void SShell::CopyCurvesSplitAgainst(bool opA, SShell *agnst, SShell *into) {
+    const SKernelContext *ctx = SKernelContext::Current();
 #pragma omp parallel for
     for(int i=0; i<curve.n; i++) {
+        SKernelContextScope scope(ctx);
         SCurve *sc = &curve[i];
         SCurve scn = sc->MakeCopySplitAgainst(agnst, NULL,
                                 surface.FindById(sc->surfA),
@@ -347,6 +349,7 @@ static void TagByClassifiedEdge(SBspUv::Class bspclass, SShell::Class *indir, SS
 
 static void DEBUGEDGELIST(SEdgeList *sel, SSurface *surf) {
     dbp("print %d edges", sel->l.n);
+    const SKernelContext *ctx = SKernelContext::Current();
     SEdge *se;
     for(se = sel->l.First(); se; se = sel->l.NextAfter(se)) {
         Vector mid = (se->a).Plus(se->b).ScaledBy(0.5);
@@ -356,64 +359,58 @@ static void DEBUGEDGELIST(SEdgeList *sel, SSurface *surf) {
         arrow = arrow.WithMagnitude(0.01);
         arrow = arrow.Plus(mid);
 
-        SS.nakedEdges.AddEdge(surf->PointAt(se->a.x, se->a.y),
-                              surf->PointAt(se->b.x, se->b.y));
-        SS.nakedEdges.AddEdge(surf->PointAt(mid.x, mid.y),
-                              surf->PointAt(arrow.x, arrow.y));
+        ctx->AddNakedEdge(surf->PointAt(se->a.x, se->a.y),
+                          surf->PointAt(se->b.x, se->b.y));
+        ctx->AddNakedEdge(surf->PointAt(mid.x, mid.y),
+                          surf->PointAt(arrow.x, arrow.y));
     }
 }
 
 //-----------------------------------------------------------------------------
-// We are given src, with at least one edge, and avoid, a list of points to
-// avoid. We return a chain of edges (that share endpoints), such that no
-// point within the avoid list ever occurs in the middle of a chain. And we
-// delete the edges in that chain from our source list.
+// We are given src, with its edges indexed by endpoint in adj, the index of
+// an untagged edge to start from, and avoid, a set of points to avoid. We
+// return a chain of edges (that share endpoints), such that no point within
+// the avoid set ever occurs in the middle of a chain. And we tag the edges in
+// that chain within our source list, so that they're not used again.
 //-----------------------------------------------------------------------------
-void SSurface::FindChainAvoiding(SEdgeList *src, SEdgeList *dest,
-                                 SPointList *avoid)
+void SSurface::FindChainAvoiding(SEdgeList *src, const SEdgeAdjacency *adj, int start,
+                                 SEdgeList *dest, const SPointIndex *avoid)
 {
-    ssassert(!src->l.IsEmpty(), "Need at least one edge");
-    // Start with an arbitrary edge.
-    dest->l.Add(src->l.First());
-    src->l.ClearTags();
-    src->l.First()->tag = 1;
-
-    bool added;
-    do {
-        added = false;
-        // The start and finish of the current edge chain
-        Vector s = dest->l.First()->a,
-               f = dest->l.Last()->b;
-
-        // We can attach a new edge at the start or finish, as long as that
-        // start or finish point isn't in the list of points to avoid.
-        bool startOkay  = !avoid->ContainsPoint(s),
-             finishOkay = !avoid->ContainsPoint(f);
-
-        // Now look for an unused edge that joins at the start or finish of
-        // our chain (if permitted by the avoid list).
-        SEdge *se;
-        for(se = src->l.First(); se; se = src->l.NextAfter(se)) {
-            if(se->tag) continue;
-            if(startOkay && s.Equals(se->b)) {
-                dest->l.AddToBeginning(se);
-                s = se->a;
-                se->tag = 1;
-                startOkay = !avoid->ContainsPoint(s);
-            } else if(finishOkay && f.Equals(se->a)) {
-                dest->l.Add(se);
-                f = se->b;
-                se->tag = 1;
-                finishOkay = !avoid->ContainsPoint(f);
-            } else {
-                continue;
-            }
+    ssassert(start >= 0 && start < src->l.n && !src->l[start].tag,
+             "Need an unused edge to start from");
+    src->l[start].tag = 1;
+
+    // Extend forwards from the finish of the chain, for as long as the finish
+    // point isn't in the list of points to avoid.
+    std::vector<int> after;
+    Vector f = src->l[start].b;
+    while(!avoid->ContainsPoint(f)) {
+        int i = adj->UntaggedEdgeStartingAt(f, src);
+        if(i < 0) break;
+        src->l[i].tag = 1;
+        after.push_back(i);
+        f = src->l[i].b;
+    }
 
-            added = true;
-        }
-    } while(added);
+    // And likewise backwards from the start.
+    std::vector<int> before;
+    Vector s = src->l[start].a;
+    while(!avoid->ContainsPoint(s)) {
+        int i = adj->UntaggedEdgeFinishingAt(s, src);
+        if(i < 0) break;
+        src->l[i].tag = 1;
+        before.push_back(i);
+        s = src->l[i].a;
+    }
 
-    src->l.RemoveTagged();
+    dest->l.ReserveMore((int)(before.size() + 1 + after.size()));
+    for(auto it = before.rbegin(); it != before.rend(); ++it) {
+        dest->l.Add(&(src->l[*it]));
+    }
+    dest->l.Add(&(src->l[start]));
+    for(int i : after) {
+        dest->l.Add(&(src->l[i]));
+    }
 }
 
 void SSurface::EdgeNormalsWithinSurface(Point2d auv, Point2d buv,
@@ -450,7 +447,7 @@ void SSurface::EdgeNormalsWithinSurface(Point2d auv, Point2d buv,
 
     // Compute the edge's inner normal in xyz space.
     Vector ab    = (PointAt(auv)).Minus(PointAt(buv)),
-           enxyz = (ab.Cross(*surfn)).WithMagnitude(SS.ChordTolMm());
+           enxyz = (ab.Cross(*surfn)).WithMagnitude(SKernelContext::Current()->chordTol);
     // And based on that, compute the edge's inner normal in uv space. This
     // vector is perpendicular to the edge in xyz, but not necessarily in uv.
     Vector tu, tv, tx, ty;
@@ -484,7 +481,8 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
                                        SShell *sha, SShell *shb,
                                        SShell *into,
                                        SSurface::CombineAs type,
-                                       int dbg_index)
+                                       int dbg_index,
+                                       const SCurveIndex *interIndex)
 {
     bool opA = (parent == sha);
     SShell *agnst = opA ? shb : sha;
@@ -520,16 +518,11 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
     // And now intersect the other shell against us
     SEdgeList inter = {};
 
-    SSurface *ss;
-    for(SCurve &sc : into->curve) {
-        if(sc.source != SCurve::Source::INTERSECTION) continue;
-        if(opA) {
-            if(sc.surfA != h) continue;
-            ss = shb->surface.FindById(sc.surfB);
-        } else {
-            if(sc.surfB != h) continue;
-            ss = sha->surface.FindById(sc.surfA);
-        }
+    const std::vector<hSCurve> *interCurves = interIndex->CurvesTrimming(h, opA);
+    for(size_t ci = 0; interCurves && ci < interCurves->size(); ci++) {
+        SCurve &sc = *(into->curve.FindById((*interCurves)[ci]));
+        SSurface *ss = opA ? shb->surface.FindById(sc.surfB)
+                           : sha->surface.FindById(sc.surfA);
         int i;
         for(i = 1; i < sc.pts.n; i++) {
             Vector a = sc.pts[i-1].p,
@@ -571,33 +564,43 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
     // the choosing points. If two edges join at a non-choosing point, then
     // they must either both be kept or both be discarded (since that would
     // otherwise create an open contour).
-    SPointList choosing = {};
+    SPointIndex endpoints = {};
+    std::vector<int> joining;
+    auto countJoining = [&](Vector p) {
+        int i = endpoints.IndexForPoint(p);
+        if(i < 0) {
+            endpoints.Add(p);
+            joining.push_back(1);
+        } else {
+            joining[i]++;
+        }
+    };
     SEdge *se;
     for(se = orig.l.First(); se; se = orig.l.NextAfter(se)) {
-        choosing.IncrementTagFor(se->a);
-        choosing.IncrementTagFor(se->b);
+        countJoining(se->a);
+        countJoining(se->b);
     }
     for(se = inter.l.First(); se; se = inter.l.NextAfter(se)) {
-        choosing.IncrementTagFor(se->a);
-        choosing.IncrementTagFor(se->b);
+        countJoining(se->a);
+        countJoining(se->b);
     }
-    SPoint *sp;
-    for(sp = choosing.l.First(); sp; sp = choosing.l.NextAfter(sp)) {
-        if(sp->tag == 2) {
-            sp->tag = 1;
-        } else {
-            sp->tag = 0;
-        }
+    SPointIndex choosing = {};
+    for(size_t i = 0; i < joining.size(); i++) {
+        if(joining[i] != 2) choosing.Add(endpoints.pts[i]);
     }
-    choosing.l.RemoveTagged();
+    endpoints.Clear();
 
     // The list of edges to trim our new surface, a combination of edges from
     // our original and intersecting edge lists.
     SEdgeList final = {};
 
-    while(!orig.l.IsEmpty()) {
+    SEdgeAdjacency adj = {};
+    adj.Build(&orig);
+    orig.l.ClearTags();
+    for(int i = 0; i < orig.l.n; i++) {
+        if(orig.l[i].tag) continue;
         SEdgeList chain = {};
-        FindChainAvoiding(&orig, &chain, &choosing);
+        FindChainAvoiding(&orig, &adj, i, &chain, &choosing);
 
         // Arbitrarily choose an edge within the chain to classify; they
         // should all be the same, though.
@@ -629,9 +632,12 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
         chain.Clear();
     }
 
-    while(!inter.l.IsEmpty()) {
+    adj.Build(&inter);
+    inter.l.ClearTags();
+    for(int i = 0; i < inter.l.n; i++) {
+        if(inter.l[i].tag) continue;
         SEdgeList chain = {};
-        FindChainAvoiding(&inter, &chain, &choosing);
+        FindChainAvoiding(&inter, &adj, i, &chain, &choosing);
 
         // Any edge in the chain, same as above.
         se = &(chain.l[chain.l.n/2]);
@@ -677,11 +683,12 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
 #pragma omp critical
     {
         into->booleanFailed = true;
-        dbp("failed: I=%d, avoid=%d", I+dbg_index, choosing.l.n);
+        dbp("failed: I=%d, avoid=%d", I+dbg_index, (int)choosing.pts.size());
         DEBUGEDGELIST(&final, &ret);
     }
     poly.Clear();
 
+    adj.Clear();
     choosing.Clear();
     final.Clear();
     inter.Clear();
@@ -689,13 +696,16 @@ SSurface SSurface::MakeCopyTrimAgainst(SShell *parent,
     return ret;
 }
 
-void SShell::CopySurfacesTrimAgainst(SShell *sha, SShell *shb, SShell *into, SSurface::CombineAs type) {
+void SShell::CopySurfacesTrimAgainst(SShell *sha, SShell *shb, SShell *into, SSurface::CombineAs type,
+                                     const SCurveIndex *interIndex) {
     std::vector <SSurface> ssn(surface.n);
+    const SKernelContext *ctx = SKernelContext::Current();
 #pragma omp parallel for
     for (int i = 0; i < surface.n; i++)
     {
+        SKernelContextScope scope(ctx);
         SSurface *ss = &surface[i];
-        ssn[i] = ss->MakeCopyTrimAgainst(this, sha, shb, into, type, i);
+        ssn[i] = ss->MakeCopyTrimAgainst(this, sha, shb, into, type, i, interIndex);
     }
 
     for (int i = 0; i < surface.n; i++)
@@ -706,8 +716,10 @@ void SShell::CopySurfacesTrimAgainst(SShell *sha, SShell *shb, SShell *into, SSu
 }
 
 void SShell::MakeIntersectionCurvesAgainst(SShell *agnst, SShell *into) {
+    const SKernelContext *ctx = SKernelContext::Current();
 #pragma omp parallel for
     for(int i = 0; i< surface.n; i++) {
+        SKernelContextScope scope(ctx);
         SSurface *sa = &surface[i];
 
         for(SSurface &sb : agnst->surface){
@@ -719,10 +731,39 @@ void SShell::MakeIntersectionCurvesAgainst(SShell *agnst, SShell *into) {
     }
 }
 
+//-----------------------------------------------------------------------------
+// Group the intersection curves in the result shell by the surface of each
+// operand that they trim. The lists keep the order of into->curve, so the
+// trims come out the same as if we'd scanned every curve for each surface.
+//-----------------------------------------------------------------------------
+void SCurveIndex::Build(SShell *into) {
+    Clear();
+    for(SCurve &sc : into->curve) {
+        if(sc.source != SCurve::Source::INTERSECTION) continue;
+        bySurfA[sc.surfA.v].push_back(sc.h);
+        bySurfB[sc.surfB.v].push_back(sc.h);
+    }
+}
+
+const std::vector<hSCurve> *SCurveIndex::CurvesTrimming(hSSurface hs, bool opA) const {
+    const std::unordered_map<uint32_t, std::vector<hSCurve>> &m = opA ? bySurfA : bySurfB;
+    auto it = m.find(hs.v);
+    if(it == m.end()) return NULL;
+    return &(it->second);
+}
+
+void SCurveIndex::Clear() {
+    bySurfA.clear();
+    bySurfB.clear();
+}
+
 void SShell::CleanupAfterBoolean() {
     for(SSurface &ss : surface) {
         ss.edges.Clear();
     }
+    edgeBvh.Clear();
+    edgeBvhItems.clear();
+    surfaceBvh.Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -819,15 +860,22 @@ void SShell::MakeFromBoolean(SShell *a, SShell *b, SSurface::CombineAs type) {
     // curves
     a->MakeClassifyingBsps(this);
     b->MakeClassifyingBsps(this);
+    // and index their edges, for classifying the trimmed edges against them
+    a->MakeClassifyingBvhs();
+    b->MakeClassifyingBvhs();
 
     if(b->surface.IsEmpty() || a->surface.IsEmpty()) {
         I = 1000000;
     } else {
         I = 0;
     }
-    // Then trim and copy the surfaces
-    a->CopySurfacesTrimAgainst(a, b, this, type);
-    b->CopySurfacesTrimAgainst(a, b, this, type);
+    // Then trim and copy the surfaces; no curves get added while we do that,
+    // so we can index the intersection curves once for both operands.
+    SCurveIndex interIndex = {};
+    interIndex.Build(this);
+    a->CopySurfacesTrimAgainst(a, b, this, type, &interIndex);
+    b->CopySurfacesTrimAgainst(a, b, this, type, &interIndex);
+    interIndex.Clear();
 
     // Now that we've copied the surfaces, we know their new hSurfaces, so
     // rewrite the curves to refer to the surfaces by their handles in the
@@ -843,12 +891,142 @@ void SShell::MakeFromBoolean(SShell *a, SShell *b, SSurface::CombineAs type) {
 // All of the BSP routines that we use to perform and accelerate polygon ops.
 //-----------------------------------------------------------------------------
 void SShell::MakeClassifyingBsps(SShell *useCurvesFrom) {
+    const SKernelContext *ctx = SKernelContext::Current();
 #pragma omp parallel for
     for(int i = 0; i<surface.n; i++) {
+        SKernelContextScope scope(ctx);
         surface[i].MakeClassifyingBsp(this, useCurvesFrom);
     }
 }
 
+//-----------------------------------------------------------------------------
+// Index the surfaces and their xyz trim edges by bounding box, so that
+// ClassifyEdge only has to test the ones near the edge being classified.
+// The boxes are padded, so that everything within the usual tolerances of
+// a query still overlaps it.
+//-----------------------------------------------------------------------------
+void SShell::MakeClassifyingBvhs() {
+    const double pad = 10*LENGTH_EPS;
+
+    edgeBvh.Clear();
+    edgeBvhItems.clear();
+    surfaceBvh.Clear();
+    for(int i = 0; i < surface.n; i++) {
+        SSurface *srf = &surface[i];
+
+        Vector amax, amin;
+        srf->GetAxisAlignedBounding(&amax, &amin);
+        BBox box = BBox::From(amax, amin);
+        box.Include(amax, pad);
+        box.Include(amin, pad);
+        surfaceBvh.Add(box);
+
+        for(int j = 0; j < srf->edges.l.n; j++) {
+            SEdge *se = &(srf->edges.l[j]);
+            box = BBox::From(se->a, se->b);
+            box.Include(se->a, pad);
+            box.Include(se->b, pad);
+            edgeBvh.Add(box);
+            edgeBvhItems.push_back({ i, j });
+        }
+    }
+    edgeBvh.Build();
+    surfaceBvh.Build();
+}
+
+void SBvh::Clear() {
+    boxes.clear();
+    order.clear();
+    nodes.clear();
+}
+
+int SBvh::Add(const BBox &box) {
+    boxes.push_back(box);
+    return (int)boxes.size() - 1;
+}
+
+void SBvh::Build() {
+    nodes.clear();
+    order.resize(boxes.size());
+    for(size_t i = 0; i < order.size(); i++) {
+        order[i] = (int)i;
+    }
+    if(!boxes.empty()) {
+        nodes.reserve(2*boxes.size());
+        BuildRange(0, (int)boxes.size());
+    }
+}
+
+// Make a node for the boxes in order[first, first+count), splitting them at
+// the median along the longest axis of their centers; returns its index.
+int SBvh::BuildRange(int first, int count) {
+    Node n = {};
+    n.box = boxes[order[first]];
+    Vector cmax = n.box.GetOrigin(), cmin = cmax;
+    for(int i = first; i < first + count; i++) {
+        const BBox &b = boxes[order[i]];
+        n.box.Include(b.minp);
+        n.box.Include(b.maxp);
+        b.GetOrigin().MakeMaxMin(&cmax, &cmin);
+    }
+    n.left = n.right = -1;
+    n.first = first;
+    n.count = count;
+
+    int ni = (int)nodes.size();
+    nodes.push_back(n);
+    if(count <= 4) return ni;
+
+    Vector ext = cmax.Minus(cmin);
+    int axis = (ext.x > ext.y && ext.x > ext.z) ? 0 : (ext.y > ext.z) ? 1 : 2;
+    int half = count / 2;
+    std::nth_element(order.begin() + first, order.begin() + first + half,
+                     order.begin() + first + count, [&](int a, int b) {
+        return boxes[a].GetOrigin().Element(axis) < boxes[b].GetOrigin().Element(axis);
+    });
+    int left  = BuildRange(first, half);
+    int right = BuildRange(first + half, count - half);
+    nodes[ni].left  = left;
+    nodes[ni].right = right;
+    return ni;
+}
+
+// Report every box that overlaps (or touches) the query, in the order that
+// they were added.
+void SBvh::FindOverlapping(const BBox &query, std::vector<int> *ids) const {
+    FindOverlapping([&](const BBox &b) {
+        return !(b.maxp.x < query.minp.x || b.minp.x > query.maxp.x ||
+                 b.maxp.y < query.minp.y || b.minp.y > query.maxp.y ||
+                 b.maxp.z < query.minp.z || b.minp.z > query.maxp.z);
+    }, ids);
+}
+
+// As above, but with a test for whether a box can hold anything of interest,
+// for queries that aren't a box themselves; it must hold for a node's box if
+// it holds for any box under that node.
+void SBvh::FindOverlapping(const std::function<bool(const BBox &)> &overlaps,
+                           std::vector<int> *ids) const {
+    ids->clear();
+    if(nodes.empty()) return;
+
+    std::vector<int> stack;
+    stack.push_back(0);
+    while(!stack.empty()) {
+        const Node &n = nodes[stack.back()];
+        stack.pop_back();
+        if(!overlaps(n.box)) continue;
+        if(n.left < 0) {
+            for(int i = n.first; i < n.first + n.count; i++) {
+                if(overlaps(boxes[order[i]])) ids->push_back(order[i]);
+            }
+        } else {
+            stack.push_back(n.left);
+            stack.push_back(n.right);
+        }
+    }
+    std::sort(ids->begin(), ids->end());
+}
+
 void SSurface::MakeClassifyingBsp(SShell *shell, SShell *useCurvesFrom) {
     SEdgeList el = {};
 
@@ -258,43 +258,200 @@ void SBezierList::CullIdenticalBeziers(bool both) {
 
 //-----------------------------------------------------------------------------
 // Find all the points where a list of Bezier curves intersects another list
-// of Bezier curves. We do this by intersecting their piecewise linearizations,
-// and then refining any intersections that we find to lie exactly on the
-// curves. So this will screw up on tangencies and stuff, but otherwise should
-// be fine.
+// of Bezier curves. We index the second list by bounding box, so that pairs
+// of curves whose boxes don't overlap are never considered.
 //-----------------------------------------------------------------------------
 void SBezierList::AllIntersectionsWith(SBezierList *sblb, SPointList *spl) const {
-    for(const SBezier *sba = l.First(); sba; sba = l.NextAfter(sba)) {
-        for(const SBezier *sbb = sblb->l.First(); sbb; sbb = sblb->l.NextAfter(sbb)) {
-            sbb->AllIntersectionsWith(sba, spl);
+    SBezierIndex index = {};
+    index.Build(sblb);
+    std::vector<SBezierInter> inters;
+    for(const SBezier &sba : l) {
+        inters.clear();
+        index.AllIntersectionsWith(&sba, &inters);
+        for(const SBezierInter &si : inters) {
+            sba.AddCrossingTo(&sblb->l[si.b], si.p, spl);
         }
     }
+    index.Clear();
 }
+
+// The box around the control points, which contains the whole curve.
+BBox SBezier::GetBoundingBox() const {
+    BBox box = BBox::From(ctrl[0], ctrl[deg]);
+    for(int i = 0; i <= deg; i++) {
+        box.Include(ctrl[i], LENGTH_EPS);
+    }
+    return box;
+}
+
+static double DepartureFromChord(const SBezier *sb) {
+    Vector p0 = sb->ctrl[0],
+           dp = sb->ctrl[sb->deg].Minus(p0);
+    bool degenerate = (dp.Magnitude() < LENGTH_EPS);
+    double d = 0;
+    for(int i = 1; i < sb->deg; i++) {
+        d = max(d, degenerate ? sb->ctrl[i].Minus(p0).Magnitude()
+                              : sb->ctrl[i].DistanceToLine(p0, dp));
+    }
+    return d;
+}
+
+static void IntersectBezierPieces(const SBezier *a, double ta0, double ta1,
+                                  const SBezier *b, double tb0, double tb1,
+                                  int depth, std::vector<std::pair<double, double>> *guesses)
+{
+    if(!(a->GetBoundingBox()).Overlaps(b->GetBoundingBox())) return;
+
+    // Nearly straight pieces are tested as line segments, with a tolerance
+    // that covers how far they depart from straight.
+    const double FLAT_EPS = 1e-3;
+    double fa = DepartureFromChord(a),
+           fb = DepartureFromChord(b);
+    if((fa < FLAT_EPS && fb < FLAT_EPS) || depth > 40) {
+        Vector a0 = a->ctrl[0], da = a->ctrl[a->deg].Minus(a0),
+               b0 = b->ctrl[0], db = b->ctrl[b->deg].Minus(b0);
+        double sa, sb;
+        if(da.Cross(db).Magnitude() < LENGTH_EPS*max(da.Magnitude(), db.Magnitude())) {
+            // Parallel, or degenerate; either there's no crossing, or they
+            // overlap and there's no single point to return.
+            return;
+        }
+        // The closest points between the two chords, as segments; a shallow
+        // crossing near an end can fall just off either chord.
+        Vector dab = a0.Minus(b0);
+        double aa = da.Dot(da), bb = db.Dot(db), ab = da.Dot(db),
+               adab = da.Dot(dab), bdab = db.Dot(dab);
+        sa = max(0.0, min(1.0, (ab*bdab - adab*bb) / (aa*bb - ab*ab)));
+        sb = (ab*sa + bdab) / bb;
+        if(sb < 0) {
+            sb = 0;
+            sa = max(0.0, min(1.0, -adab / aa));
+        } else if(sb > 1) {
+            sb = 1;
+            sa = max(0.0, min(1.0, (ab - adab) / aa));
+        }
+        Vector pa = a0.Plus(da.ScaledBy(sa)),
+               pb = b0.Plus(db.ScaledBy(sb));
+        if(!pa.Equals(pb, fa + fb + LENGTH_EPS)) return;
+
+        guesses->push_back({ ta0 + (ta1 - ta0)*sa, tb0 + (tb1 - tb0)*sb });
+        return;
+    }
+
+    SBezier bef, aft;
+    Vector ea = a->GetBoundingBox().GetExtents(),
+           eb = b->GetBoundingBox().GetExtents();
+    if(fa >= FLAT_EPS && (fb < FLAT_EPS || ea.Magnitude() >= eb.Magnitude())) {
+        double tam = (ta0 + ta1) / 2;
+        a->SplitAt(0.5, &bef, &aft);
+        IntersectBezierPieces(&bef, ta0, tam, b, tb0, tb1, depth + 1, guesses);
+        IntersectBezierPieces(&aft, tam, ta1, b, tb0, tb1, depth + 1, guesses);
+    } else {
+        double tbm = (tb0 + tb1) / 2;
+        b->SplitAt(0.5, &bef, &aft);
+        IntersectBezierPieces(a, ta0, ta1, &bef, tb0, tbm, depth + 1, guesses);
+        IntersectBezierPieces(a, ta0, ta1, &aft, tbm, tb1, depth + 1, guesses);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Find all the points where two Bezier curves intersect, by subdividing both
+// of them. A curve lies within the convex hull of its control points, so any
+// pair of pieces whose control points have disjoint bounding boxes can't
+// intersect; otherwise we split the larger piece in half, until both are
+// nearly straight. The intersection of their chords is then a good initial
+// guess, which we refine to lie exactly on both curves. Like any Newton's
+// method, this will miss tangencies. Curves that overlap along part of their
+// length (like two collinear line segments) have no isolated intersection
+// there, so we return no point for that; not even where one of them ends.
+//-----------------------------------------------------------------------------
+void SBezier::AllIntersectionsWith(const SBezier *sbb,
+                                   std::vector<SBezierInter> *inters) const
+{
+    std::vector<std::pair<double, double>> guesses;
+    IntersectBezierPieces(this, 0, 1, sbb, 0, 1, 0, &guesses);
+
+    size_t first = inters->size();
+    for(const auto &guess : guesses) {
+        double ta = guess.first,
+               tb = guess.second;
+        Vector p;
+        bool found = PointOnThisAndCurve(sbb, &ta, &tb, &p);
+        if(!found) continue;
+        // The intersection may lie just past an endpoint; accept that if
+        // the endpoint itself is close enough.
+        double tac = max(0.0, min(1.0, ta)),
+               tbc = max(0.0, min(1.0, tb));
+        if(!(this->PointAt(tac).Equals(p) && sbb->PointAt(tbc).Equals(p))) continue;
+        // Curves that overlap meet everywhere along their length, always with
+        // the same tangent; there's no single point to return for that.
+        Vector da = this->TangentAt(tac).WithMagnitude(1),
+               db = sbb ->TangentAt(tbc).WithMagnitude(1);
+        if(da.Cross(db).Magnitude() < 1e-6) continue;
+
+        // Neighbouring pieces will often find the same intersection.
+        if(std::any_of(inters->begin() + first, inters->end(),
+                       [&](const SBezierInter &si) { return si.p.Equals(p); })) {
+            continue;
+        }
+
+        SBezierInter si = {};
+        si.p  = p;
+        si.ta = tac;
+        si.tb = tbc;
+        inters->push_back(si);
+    }
+}
+
 void SBezier::AllIntersectionsWith(const SBezier *sbb, SPointList *spl) const {
-    SPointList splRaw = {};
-    SEdgeList sea, seb;
-    sea = {};
-    seb = {};
-    this->MakePwlInto(&sea);
-    sbb ->MakePwlInto(&seb);
-    SEdge *se;
-    for(se = sea.l.First(); se; se = sea.l.NextAfter(se)) {
-        // This isn't quite correct, since AnyEdgeCrossings doesn't count
-        // the case where two pairs of line segments intersect at their
-        // vertices. So this isn't robust, although that case isn't very
-        // likely.
-        seb.AnyEdgeCrossings(se->a, se->b, NULL, &splRaw);
-    }
-    SPoint *sp;
-    for(sp = splRaw.l.First(); sp; sp = splRaw.l.NextAfter(sp)) {
-        Vector p = sp->p;
-        if(PointOnThisAndCurve(sbb, &p)) {
-            if(!spl->ContainsPoint(p)) spl->Add(p);
+    std::vector<SBezierInter> inters;
+    AllIntersectionsWith(sbb, &inters);
+    for(const SBezierInter &si : inters) {
+        AddCrossingTo(sbb, si.p, spl);
+    }
+}
+
+void SBezier::AddCrossingTo(const SBezier *sbb, Vector p, SPointList *spl) const {
+    // Curves that just share an endpoint don't cross there.
+    if((p.Equals(Start()) || p.Equals(Finish())) &&
+       (p.Equals(sbb->Start()) || p.Equals(sbb->Finish())))
+    {
+        return;
+    }
+    if(!spl->ContainsPoint(p)) spl->Add(p);
+}
+
+//-----------------------------------------------------------------------------
+// Intersect one curve against every curve in a list, for example everything
+// in a workplane, through a bounding volume hierarchy over that list; so the
+// hierarchy is built once and queried for each curve we're trimming.
+//-----------------------------------------------------------------------------
+void SBezierIndex::Build(const SBezierList *sbl) {
+    list = sbl;
+    bvh.Clear();
+    for(const SBezier &sb : sbl->l) {
+        bvh.Add(sb.GetBoundingBox());
+    }
+    bvh.Build();
+}
+
+void SBezierIndex::AllIntersectionsWith(const SBezier *sb,
+                                        std::vector<SBezierInter> *inters) const
+{
+    std::vector<int> near;
+    bvh.FindOverlapping(sb->GetBoundingBox(), &near);
+    for(int i : near) {
+        size_t first = inters->size();
+        sb->AllIntersectionsWith(&list->l[i], inters);
+        for(size_t j = first; j < inters->size(); j++) {
+            (*inters)[j].b = i;
         }
     }
-    sea.Clear();
-    seb.Clear();
-    splRaw.Clear();
+}
+
+void SBezierIndex::Clear() {
+    list = NULL;
+    bvh.Clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -380,64 +537,55 @@ bool SBezierList::GetPlaneContainingBeziers(Vector *p, Vector *u, Vector *v,
 }
 
 //-----------------------------------------------------------------------------
-// Assemble curves in sbl into a single loop. The curves may appear in any
-// direction (start to finish, or finish to start), and will be reversed if
-// necessary. The curves in the returned loop are removed from sbl, even if
-// the loop cannot be closed.
+// Assemble curves in sbl into a single loop, starting from the curve at index
+// first. The curves may appear in any direction (start to finish, or finish
+// to start), and will be reversed if necessary. Only untagged curves are
+// used, and the ones in the returned loop are tagged, even if the loop cannot
+// be closed. The starts and finishes index the curves' endpoints as they were
+// before any of them got reversed, so that we don't have to search the list
+// for the next curve.
 //-----------------------------------------------------------------------------
-SBezierLoop SBezierLoop::FromCurves(SBezierList *sbl,
+SBezierLoop SBezierLoop::FromCurves(SBezierList *sbl, int first,
+                                    const SPointIndex *starts,
+                                    const SPointIndex *finishes,
                                     bool *allClosed, SEdge *errorAt)
 {
     SBezierLoop loop = {};
 
-    if(sbl->l.n < 1) return loop;
-    sbl->l.ClearTags();
-
-    SBezier *first = &(sbl->l[0]);
-    first->tag = 1;
-    loop.l.Add(first);
-    Vector start = first->Start();
-    Vector hanging = first->Finish();
-    int auxA = first->auxA;
-
-    sbl->l.RemoveTagged();
-
-    while(!sbl->l.IsEmpty() && !hanging.Equals(start)) {
-        int i;
-        bool foundNext = false;
-        for(i = 0; i < sbl->l.n; i++) {
-            SBezier *test = &(sbl->l[i]);
-
-            if((test->Finish()).Equals(hanging) && test->auxA == auxA) {
-                test->Reverse();
-                // and let the next test catch it
-            }
-            if((test->Start()).Equals(hanging) && test->auxA == auxA) {
-                test->tag = 1;
-                loop.l.Add(test);
-                hanging = test->Finish();
-                sbl->l.RemoveTagged();
-                foundNext = true;
-                break;
-            }
-        }
-        if(!foundNext) {
-            // The loop completed without finding the hanging edge, so
-            // it's an open loop
+    SBezier *sb = &(sbl->l[first]);
+    sb->tag = 1;
+    loop.l.Add(sb);
+    Vector start = sb->Start();
+    Vector hanging = sb->Finish();
+    int auxA = sb->auxA;
+
+    auto usable = [&](int i) {
+        return sbl->l[i].tag == 0 && sbl->l[i].auxA == auxA;
+    };
+    while(!hanging.Equals(start)) {
+        // Take the first remaining curve in the list that joins up, as
+        // though we'd searched the list from the beginning.
+        int i = starts->IndexForPoint(hanging, usable),
+            j = finishes->IndexForPoint(hanging, usable);
+        if(i < 0 || (j >= 0 && j < i)) i = j;
+        if(i < 0) {
+            // We ran out of edges without forming a closed loop, so it's
+            // an open loop
             errorAt->a = hanging;
             errorAt->b = start;
             *allClosed = false;
             return loop;
         }
+
+        SBezier *test = &(sbl->l[i]);
+        if((test->Finish()).Equals(hanging)) {
+            test->Reverse();
+        }
+        test->tag = 1;
+        loop.l.Add(test);
+        hanging = test->Finish();
     }
-    if(hanging.Equals(start)) {
-        *allClosed = true;
-    } else {
-        // We ran out of edges without forming a closed loop.
-        errorAt->a = hanging;
-        errorAt->b = start;
-        *allClosed = false;
-    }
+    *allClosed = true;
 
     return loop;
 }
@@ -496,11 +644,21 @@ SBezierLoopSet SBezierLoopSet::From(SBezierList *sbl, SPolygon *poly,
 {
     SBezierLoopSet ret = {};
 
+    SPointIndex starts, finishes;
+    for(const SBezier &sb : sbl->l) {
+        starts.Add(sb.Start());
+        finishes.Add(sb.Finish());
+    }
+    sbl->l.ClearTags();
+
     *allClosed = true;
-    while(!sbl->l.IsEmpty()) {
+    for(int i = 0; i < sbl->l.n; i++) {
+        if(sbl->l[i].tag) continue;
+
         bool thisClosed;
         SBezierLoop loop;
-        loop = SBezierLoop::FromCurves(sbl, &thisClosed, errorAt);
+        loop = SBezierLoop::FromCurves(sbl, i, &starts, &finishes,
+                                       &thisClosed, errorAt);
         if(!thisClosed) {
             // Record open loops in a separate list, if requested.
             *allClosed = false;
@@ -515,6 +673,8 @@ SBezierLoopSet SBezierLoopSet::From(SBezierList *sbl, SPolygon *poly,
             loop.MakePwlInto(poly->l.Last(), chordTol);
         }
     }
+    // Every curve is in some loop now.
+    sbl->l.RemoveTagged();
 
     poly->normal = poly->ComputeNormal();
     ret.normal = poly->normal;
@@ -718,6 +878,42 @@ void SBezierLoopSetSet::FindOuterFacesFrom(SBezierList *sbl, SPolygon *spxyz,
     spuv.Clear();
 }
 
+//-----------------------------------------------------------------------------
+// Assemble the curves in sbl into loops, like FindOuterFacesFrom, but without
+// working out which closed loops are holes in which; for when we just need
+// the paths. The closed loops all go into a single loop set, and the open
+// ones into openContours.
+//-----------------------------------------------------------------------------
+void SBezierLoopSetSet::FindPathsFrom(SBezierList *sbl,
+                                      SBezierLoopSet *openContours)
+{
+    SPointIndex starts, finishes;
+    for(const SBezier &sb : sbl->l) {
+        starts.Add(sb.Start());
+        finishes.Add(sb.Finish());
+    }
+    sbl->l.ClearTags();
+
+    SBezierLoopSet closed = {};
+    for(int i = 0; i < sbl->l.n; i++) {
+        if(sbl->l[i].tag) continue;
+
+        bool thisClosed;
+        SEdge errorAt;
+        SBezierLoop loop = SBezierLoop::FromCurves(sbl, i, &starts, &finishes,
+                                                   &thisClosed, &errorAt);
+        if(thisClosed) {
+            closed.l.Add(&loop);
+        } else {
+            openContours->l.Add(&loop);
+        }
+    }
+    sbl->l.RemoveTagged();
+
+    if(closed.l.IsEmpty()) return;
+    l.Add(&closed);
+}
+
 void SBezierLoopSetSet::AddOpenPath(SBezier *sb) {
     SBezierLoop sbl = {};
     sbl.l.Add(sb);
@@ -843,7 +1039,7 @@ void SCurve::RemoveShortSegments(SSurface *srfA, SSurface *srfB) {
             srf->ClosestPointTo(prev,   &(puv.x), &(puv.y));
             srf->ClosestPointTo(scn->p, &(nuv.x), &(nuv.y));
 
-            if(srf->ChordToleranceForEdge(nuv, puv) > SS.ChordTolMm() ) {
+            if(srf->ChordToleranceForEdge(nuv, puv) > SKernelContext::Current()->chordTol) {
                 mustKeep = true;
             }
         }
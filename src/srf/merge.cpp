@@ -6,15 +6,50 @@
 //-----------------------------------------------------------------------------
 #include "../solvespace.h"
 
+//-----------------------------------------------------------------------------
+// Coincident planes must have nearly the same normal and offset, so we bucket
+// the planar surfaces by colour and by their quantized plane, and compare a
+// surface only against those in its own and the adjacent buckets. The cells
+// are sized so that any pair that CoincidentWith() accepts lands in adjacent
+// buckets, as long as the surfaces aren't so tiny (under about 0.02 mm) that
+// their normals can differ by more than a cell while still coincident.
+//-----------------------------------------------------------------------------
+namespace {
+struct PlaneKey {
+    uint32_t color;
+    int64_t  nx, ny, nz, d;
+
+    bool operator==(const PlaneKey &k) const {
+        return color == k.color && nx == k.nx && ny == k.ny && nz == k.nz && d == k.d;
+    }
+};
+
+struct PlaneKeyHash {
+    size_t operator()(const PlaneKey &k) const {
+        uint64_t h = k.color;
+        h = h * 0x9E3779B97F4A7C15ull ^ (uint64_t)k.nx;
+        h = h * 0x9E3779B97F4A7C15ull ^ (uint64_t)k.ny;
+        h = h * 0x9E3779B97F4A7C15ull ^ (uint64_t)k.nz;
+        h = h * 0x9E3779B97F4A7C15ull ^ (uint64_t)k.d;
+        return (size_t)h;
+    }
+};
+}
+
+static const double PLANE_KEY_NORMAL_CELL = 1e-4;
+
 void SShell::MergeCoincidentSurfaces() {
     surface.ClearTags();
 
     int i, j;
     SSurface *si, *sj;
 
+    // The surfaces that we can merge at all, and the size of the model, which
+    // bounds how far apart the offsets of two coincident planes can be.
+    std::vector<bool> mergeable(surface.n, false);
+    double extent = 1.0;
     for(i = 0; i < surface.n; i++) {
         si = &(surface[i]);
-        if(si->tag) continue;
         // Let someone else clean up the empty surfaces; we can certainly merge
         // them, but we don't know how to calculate a reasonable bounding box.
         if(si->trim.IsEmpty())
@@ -22,15 +57,83 @@ void SShell::MergeCoincidentSurfaces() {
         // And for now we handle only coincident planes, so no sense wasting
         // time on other surfaces.
         if(si->degm != 1 || si->degn != 1) continue;
+        mergeable[i] = true;
+        extent = max(extent, (si->ctrl[0][0]).Magnitude());
+    }
+    double offsetCell = 2*PLANE_KEY_NORMAL_CELL*extent + 2*LENGTH_EPS;
+
+    std::vector<PlaneKey> keys(surface.n);
+    std::unordered_map<PlaneKey, std::vector<int>, PlaneKeyHash> buckets;
+    for(i = 0; i < surface.n; i++) {
+        if(!mergeable[i]) continue;
+        si = &(surface[i]);
+        Vector n = si->NormalAt(0, 0).WithMagnitude(1);
+        double d = n.Dot(si->ctrl[0][0]);
+        keys[i] = { si->color.ToPackedInt(),
+                    (int64_t)floor(n.x / PLANE_KEY_NORMAL_CELL),
+                    (int64_t)floor(n.y / PLANE_KEY_NORMAL_CELL),
+                    (int64_t)floor(n.z / PLANE_KEY_NORMAL_CELL),
+                    (int64_t)floor(d / offsetCell) };
+        buckets[keys[i]].push_back(i);
+    }
+
+    // The xyz edges of each surface, made on first use; these don't change
+    // while we merge, since we only rewrite the trims of the merged surface.
+    std::vector<SEdgeList> edgesOf(surface.n);
+    std::vector<bool> madeEdges(surface.n, false);
+    auto edgesFor = [&](int k) {
+        if(!madeEdges[k]) {
+            edgesOf[k] = {};
+            surface[k].MakeEdgesInto(this, &edgesOf[k], SSurface::MakeAs::XYZ);
+            madeEdges[k] = true;
+        }
+        return &edgesOf[k];
+    };
+
+    // The surface that each merged surface was merged into, so that we can
+    // rewrite the curves all at once.
+    std::unordered_map<uint32_t, hSSurface> mergedInto;
+
+    for(i = 0; i < surface.n; i++) {
+        si = &(surface[i]);
+        if(si->tag) continue;
+        if(!mergeable[i]) continue;
+
+        std::vector<int> candidates;
+        const PlaneKey &ki = keys[i];
+        for(int64_t dnx = -1; dnx <= 1; dnx++) {
+            for(int64_t dny = -1; dny <= 1; dny++) {
+                for(int64_t dnz = -1; dnz <= 1; dnz++) {
+                    for(int64_t dd = -1; dd <= 1; dd++) {
+                        PlaneKey k = { ki.color, ki.nx + dnx, ki.ny + dny, ki.nz + dnz,
+                                       ki.d + dd };
+                        auto it = buckets.find(k);
+                        if(it == buckets.end()) continue;
+                        for(int c : it->second) {
+                            if(c > i) candidates.push_back(c);
+                        }
+                    }
+                }
+            }
+        }
+        if(candidates.empty()) continue;
+        std::sort(candidates.begin(), candidates.end());
 
         SEdgeList sel = {};
-        si->MakeEdgesInto(this, &sel, SSurface::MakeAs::XYZ);
+        for(const SEdge &se : edgesFor(i)->l) {
+            sel.l.Add(&se);
+        }
+        // The merged edges, indexed by endpoint; we extend this as we merge
+        // rather than rebuilding it for every candidate.
+        SEdgeAdjacency selAdj = {};
+        selAdj.Build(&sel);
 
         bool mergedThisTime, merged = false;
         do {
             mergedThisTime = false;
 
-            for(j = i + 1; j < surface.n; j++) {
+            for(int c : candidates) {
+                j = c;
                 sj = &(surface[j]);
                 if(sj->tag) continue;
                 if(!sj->CoincidentWith(si, /*sameNormal=*/true)) continue;
@@ -42,32 +145,36 @@ void SShell::MergeCoincidentSurfaces() {
                 // surfaces if they contain disjoint contours; that just makes
                 // the bounding box tests less effective, and possibly things
                 // less robust.
-                SEdgeList tel = {};
-                sj->MakeEdgesInto(this, &tel, SSurface::MakeAs::XYZ);
-                if(!sel.ContainsEdgeFrom(&tel)) {
-                    tel.Clear();
-                    continue;
+                SEdgeList *tel = edgesFor(j);
+                bool touches = false;
+                for(const SEdge &se : tel->l) {
+                    if(sel.ContainsEdge(&se, &selAdj)) {
+                        touches = true;
+                        break;
+                    }
                 }
-                tel.Clear();
+                if(!touches) continue;
 
                 sj->tag = 1;
                 merged = true;
                 mergedThisTime = true;
-                sj->MakeEdgesInto(this, &sel, SSurface::MakeAs::XYZ);
+                for(const SEdge &se : tel->l) {
+                    sel.l.Add(&se);
+                    selAdj.starts.Add(se.a);
+                    selAdj.finishes.Add(se.b);
+                }
                 sj->trim.Clear();
 
                 // All the references to this surface get replaced with the
                 // new srf
-                for(SCurve &sc : curve) {
-                    if(sc.surfA == sj->h) sc.surfA = si->h;
-                    if(sc.surfB == sj->h) sc.surfB = si->h;
-                }
+                mergedInto[sj->h.v] = si->h;
             }
 
             // If this iteration merged a contour onto ours, then we have to
             // go through the surfaces again; that might have made a new
             // surface touch us.
         } while(mergedThisTime);
+        selAdj.Clear();
 
         if(merged) {
             sel.CullExtraneousEdges();
@@ -100,7 +207,7 @@ void SShell::MergeCoincidentSurfaces() {
             // in that case. So give a bit of extra room; in theory just
             // a chord tolerance, but more can't hurt.
             double muv = max((umax - umin), (vmax - vmin));
-            double tol = muv/50 + 3*SS.ChordTolMm();
+            double tol = muv/50 + 3*SKernelContext::Current()->chordTol;
             umax += tol;
             vmax += tol;
             umin -= tol;
@@ -122,6 +229,18 @@ void SShell::MergeCoincidentSurfaces() {
         sel.Clear();
     }
 
+    if(!mergedInto.empty()) {
+        for(SCurve &sc : curve) {
+            auto it = mergedInto.find(sc.surfA.v);
+            if(it != mergedInto.end()) sc.surfA = it->second;
+            it = mergedInto.find(sc.surfB.v);
+            if(it != mergedInto.end()) sc.surfB = it->second;
+        }
+    }
+
+    for(SEdgeList &el : edgesOf) {
+        el.Clear();
+    }
     surface.RemoveTagged();
 }
 
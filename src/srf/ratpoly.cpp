@@ -109,13 +109,20 @@ bool SBezier::PointOnThisAndCurve(const SBezier *sbb, Vector *p) const {
     double ta, tb;
     this->ClosestPointTo(*p, &ta, /*mustConverge=*/false);
     sbb ->ClosestPointTo(*p, &tb, /*mustConverge=*/false);
+    return PointOnThisAndCurve(sbb, &ta, &tb, p);
+}
 
+// Same, starting from a guess at the parameter on each curve, and returning
+// the parameters of the point that we find.
+bool SBezier::PointOnThisAndCurve(const SBezier *sbb, double *ta, double *tb,
+                                  Vector *p) const
+{
     int i;
     for(i = 0; i < 20; i++) {
-        Vector pa = this->PointAt(ta),
-               pb = sbb ->PointAt(tb),
-               da = this->TangentAt(ta),
-               db = sbb ->TangentAt(tb);
+        Vector pa = this->PointAt(*ta),
+               pb = sbb ->PointAt(*tb),
+               da = this->TangentAt(*ta),
+               db = sbb ->TangentAt(*tb);
 
         if(pa.Equals(pb, RATPOLY_EPS)) {
             *p = pa;
@@ -124,8 +131,8 @@ bool SBezier::PointOnThisAndCurve(const SBezier *sbb, Vector *p) const {
 
         double tta, ttb;
         Vector::ClosestPointBetweenLines(pa, da, pb, db, &tta, &ttb);
-        ta += tta;
-        tb += ttb;
+        *ta += tta;
+        *tb += ttb;
     }
     return false;
 }
@@ -209,7 +216,7 @@ void SBezier::MakePwlInto(SContour *sc, double chordTol, double max_dt) const {
 void SBezier::MakePwlInto(List<Vector> *l, double chordTol, double max_dt) const {
     if(EXACT(chordTol == 0)) {
         // Use the default chord tolerance.
-        chordTol = SS.ChordTolMm();
+        chordTol = SKernelContext::Current()->chordTol;
     }
     // Never do fewer than three intermediate points for curves; people seem to get
     // unhappy when their circles turn into squares, but maybe less
@@ -234,7 +241,7 @@ void SBezier::MakePwlWorker(List<Vector> *l, double ta, double tb, double chordT
     Vector pm = PointAt((ta + tb) / 2.0);
     double d = pm.DistanceToLine(pa, pb.Minus(pa));
 
-    double step = 1.0/SS.GetMaxSegments();
+    double step = 1.0/SKernelContext::Current()->maxSegments;
     if(((tb - ta) < step || d < chordTol) && ((tb-ta) <= max_dt) ) {
         // A previous call has already added the beginning of our interval.
         l->Add(&pb);
@@ -264,7 +271,7 @@ void SBezier::MakePwlInitialWorker(List<Vector> *l, double ta, double tb, double
                    pm3.DistanceToLine(pa, dir)
                 });
 
-    double step = 1.0/SS.GetMaxSegments();
+    double step = 1.0/SKernelContext::Current()->maxSegments;
     if( ((tb - ta) < step || d < chordTol) && ((tb-ta) <= max_dt) ) {
         // A previous call has already added the beginning of our interval.
         l->Add(&pb);
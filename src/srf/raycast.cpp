@@ -204,7 +204,7 @@ void SSurface::AllPointsIntersectingUntrimmed(Vector a, Vector b,
 
     // If we might intersect, and the surface is small, then switch to Newton
     // iterations.
-    if(DepartureFromCoplanar() < 0.2*SS.ChordTolMm()) {
+    if(DepartureFromCoplanar() < 0.2*SKernelContext::Current()->chordTol) {
         Vector p = (ctrl[0   ][0   ]).Plus(
                     ctrl[0   ][degn]).Plus(
                     ctrl[degm][0   ]).Plus(
@@ -430,33 +430,65 @@ bool SShell::ClassifyEdge(Class *indir, Class *outdir,
 {
     List<SInter> l = {};
 
+    // If we've been indexed for classification, then we need only test the
+    // edges and surfaces that lie near our edge; otherwise test them all.
+    // Either way we visit them in the same order, so get the same result.
+    bool indexed = !surfaceBvh.nodes.empty();
+    std::vector<int> near, nearA;
+
     // First, check for edge-on-edge
     int edge_inters = 0;
     Vector inter_surf_n[2], inter_edge_n[2];
-    for(SSurface &srf : surface) {
-        if(srf.LineEntirelyOutsideBbox(ea, eb, /*asSegment=*/true)) continue;
+    auto testEdgeOnEdge = [&](SSurface &srf, SEdge *se) {
+        if((ea.Equals(se->a) && eb.Equals(se->b)) ||
+           (eb.Equals(se->a) && ea.Equals(se->b)) ||
+            p.OnLineSegment(se->a, se->b))
+        {
+            if(edge_inters < 2) {
+                // Edge-on-edge case
+                Point2d pm;
+                srf.ClosestPointTo(p,  &pm, /*mustConverge=*/false);
+                // A vector normal to the surface, at the intersection point
+                inter_surf_n[edge_inters] = srf.NormalAt(pm);
+                // A vector normal to the intersecting edge (but within the
+                // intersecting surface) at the intersection point, pointing
+                // out.
+                inter_edge_n[edge_inters] =
+                  (inter_surf_n[edge_inters]).Cross((se->b).Minus((se->a)));
+            }
 
-        SEdgeList *sel = &(srf.edges);
-        SEdge *se;
-        for(se = sel->l.First(); se; se = sel->l.NextAfter(se)) {
-            if((ea.Equals(se->a) && eb.Equals(se->b)) ||
-               (eb.Equals(se->a) && ea.Equals(se->b)) ||
-                p.OnLineSegment(se->a, se->b))
-            {
-                if(edge_inters < 2) {
-                    // Edge-on-edge case
-                    Point2d pm;
-                    srf.ClosestPointTo(p,  &pm, /*mustConverge=*/false);
-                    // A vector normal to the surface, at the intersection point
-                    inter_surf_n[edge_inters] = srf.NormalAt(pm);
-                    // A vector normal to the intersecting edge (but within the
-                    // intersecting surface) at the intersection point, pointing
-                    // out.
-                    inter_edge_n[edge_inters] =
-                      (inter_surf_n[edge_inters]).Cross((se->b).Minus((se->a)));
-                }
+            edge_inters++;
+        }
+    };
+    if(indexed) {
+        // An edge that we match either has an endpoint at ea, or contains p.
+        edgeBvh.FindOverlapping(BBox::From(p, p), &near);
+        edgeBvh.FindOverlapping(BBox::From(ea, ea), &nearA);
+        near.insert(near.end(), nearA.begin(), nearA.end());
+        std::sort(near.begin(), near.end());
+        near.erase(std::unique(near.begin(), near.end()), near.end());
+
+        int lastSrf = -1;
+        bool outside = true;
+        for(int id : near) {
+            int si = edgeBvhItems[id].first,
+                ei = edgeBvhItems[id].second;
+            SSurface &srf = surface[si];
+            if(si != lastSrf) {
+                outside = srf.LineEntirelyOutsideBbox(ea, eb, /*asSegment=*/true);
+                lastSrf = si;
+            }
+            if(outside) continue;
+            testEdgeOnEdge(srf, &(srf.edges.l[ei]));
+        }
+    } else {
+        for(SSurface &srf : surface) {
+            if(srf.LineEntirelyOutsideBbox(ea, eb, /*asSegment=*/true)) continue;
 
-                edge_inters++;
+            SEdgeList *sel = &(srf.edges);
+            SEdge *se;
+            for(se = sel->l.First(); se; se = sel->l.NextAfter(se)) {
+                testEdgeOnEdge(srf, se);
             }
         }
     }
@@ -518,7 +550,16 @@ bool SShell::ClassifyEdge(Class *indir, Class *outdir,
     // are on surface) and for numerical stability, so we don't pick up
     // the additional error from the line intersection.
 
-    for(SSurface &srf : surface) {
+    if(indexed) {
+        surfaceBvh.FindOverlapping(BBox::From(ea, eb), &near);
+    } else {
+        near.resize(surface.n);
+        for(int i = 0; i < surface.n; i++) {
+            near[i] = i;
+        }
+    }
+    for(int i : near) {
+        SSurface &srf = surface[i];
         if(srf.LineEntirelyOutsideBbox(ea, eb, /*asSegment=*/true)) continue;
 
         Point2d puv;
@@ -603,7 +644,7 @@ bool SShell::ClassifyEdge(Class *indir, Class *outdir,
         if(cnt > 5) {
             dbp("can't find a ray that doesn't hit on edge!");
             dbp("on edge = %d, edge_inters = %d", onEdge, edge_inters);
-            SS.nakedEdges.AddEdge(ea, eb);
+            SKernelContext::Current()->AddNakedEdge(ea, eb);
             break;
         }
     }
@@ -6,6 +6,37 @@
 //-----------------------------------------------------------------------------
 #include "../solvespace.h"
 
+static thread_local const SKernelContext *CurrentKernelContext = NULL;
+
+const SKernelContext *SKernelContext::Current() {
+    if(CurrentKernelContext != NULL) return CurrentKernelContext;
+
+    // The settings may change between operations (e.g. when exporting), so
+    // look at them again every time.
+    static thread_local SKernelContext fromSettings;
+    fromSettings = FromSettings();
+    return &fromSettings;
+}
+
+void SKernelContext::AddNakedEdge(Vector a, Vector b) const {
+    if(nakedEdges == NULL) return;
+#pragma omp critical(nakedEdges)
+    nakedEdges->AddEdge(a, b);
+}
+
+bool SKernelContext::FaceExists(uint32_t face) const {
+    return faceExists && faceExists(face);
+}
+
+SKernelContextScope::SKernelContextScope(const SKernelContext *ctx) {
+    prev = CurrentKernelContext;
+    CurrentKernelContext = ctx;
+}
+
+SKernelContextScope::~SKernelContextScope() {
+    CurrentKernelContext = prev;
+}
+
 SSurface SSurface::FromExtrusionOf(SBezier *sb, Vector t0, Vector t1) {
     SSurface ret = {};
 
@@ -382,7 +413,7 @@ void SSurface::MakeSectionEdgesInto(SShell *shell, SEdgeList *sel, SBezierList *
                         double t;
                         sb.ClosestPointTo(p, &t, /*mustConverge=*/false);
                         Vector pp = sb.PointAt(t);
-                        if((pp.Minus(p)).Magnitude() > SS.ChordTolMm()/2) {
+                        if((pp.Minus(p)).Magnitude() > SKernelContext::Current()->chordTol/2) {
                             tooFar = true;
                             break;
                         }
@@ -719,7 +750,7 @@ void SShell::MakeFromHelicalRevolutionOf(SBezierLoopSet *sbls, Vector pt, Vector
                         hEntity he;
                         he.v          = sb->entity;
                         hEntity hface = group->Remap(he, Group::REMAP_LINE_TO_FACE);
-                        if(SK.entity.FindByIdNoOops(hface) != NULL) {
+                        if(SKernelContext::Current()->FaceExists(hface.v)) {
                             ss.face = hface.v;
                         }
                     }
@@ -871,7 +902,7 @@ void SShell::MakeFromRevolutionOf(SBezierLoopSet *sbls, Vector pt, Vector axis,
                         hEntity he;
                         he.v = sb->entity;
                         hEntity hface = group->Remap(he, Group::REMAP_LINE_TO_FACE);
-                        if(SK.entity.FindByIdNoOops(hface) != NULL) {
+                        if(SKernelContext::Current()->FaceExists(hface.v)) {
                             ss.face = hface.v;
                         }
                     }
@@ -1068,8 +1099,10 @@ void SShell::MakeSectionEdgesInto(Vector n, double d, SEdgeList *sel, SBezierLis
 }
 
 void SShell::TriangulateInto(SMesh *sm) {
+    const SKernelContext *ctx = SKernelContext::Current();
 #pragma omp parallel for
     for(int i=0; i<surface.n; i++) {
+        SKernelContextScope scope(ctx);
         SSurface *s = &surface[i];
         SMesh m;
         s->TriangulateInto(this, &m);
@@ -1093,4 +1126,8 @@ void SShell::Clear() {
         c.Clear();
     }
     curve.Clear();
+
+    edgeBvh.Clear();
+    edgeBvhItems.clear();
+    surfaceBvh.Clear();
 }
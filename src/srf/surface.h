@@ -14,6 +14,41 @@ class SBezierList;
 class SSurface;
 class SCurvePt;
 
+// The tolerances and limits that the geometry kernel works to, where it
+// reports the edges that it couldn't make sense of, and how it asks which
+// faces exist in the sketch. Each thread has its own current context, so that
+// shells for different models or with different tolerances can be built at
+// the same time; when none is set, the kernel follows the application's
+// settings.
+class SKernelContext {
+public:
+    double      chordTol;
+    int         maxSegments;
+    SEdgeList   *nakedEdges;
+    // Whether the face entity with this handle exists, so that surfaces can
+    // be tagged with it; none do if this isn't set.
+    std::function<bool(uint32_t)> faceExists;
+
+    static SKernelContext FromSettings();
+    static const SKernelContext *Current();
+
+    void AddNakedEdge(Vector a, Vector b) const;
+    bool FaceExists(uint32_t face) const;
+};
+
+// Makes a context current on this thread, until the scope ends. OpenMP
+// workers don't inherit it, so parallel loops must set it up again inside.
+class SKernelContextScope {
+public:
+    const SKernelContext *prev;
+
+    SKernelContextScope(const SKernelContext *ctx);
+    ~SKernelContextScope();
+
+    SKernelContextScope(const SKernelContextScope &) = delete;
+    SKernelContextScope &operator=(const SKernelContextScope &) = delete;
+};
+
 // Utility data structure, a two-dimensional BSP to accelerate polygon
 // operations.
 class SBspUv {
@@ -70,6 +105,15 @@ public:
 template<>
 struct IsHandleOracle<hSCurve> : std::true_type {};
 
+// An intersection between two curves, with the parameter of the point on
+// each; and which curve b was, when intersecting against a list.
+class SBezierInter {
+public:
+    Vector      p;
+    double      ta, tb;
+    int         b;
+};
+
 // Stuff for rational polynomial curves, of degree one to three. These are
 // our inputs, and are also calculated for certain exact surface-surface
 // intersections.
@@ -88,6 +132,7 @@ public:
     void ClosestPointTo(Vector p, double *t, bool mustConverge=true) const;
     void SplitAt(double t, SBezier *bef, SBezier *aft) const;
     bool PointOnThisAndCurve(const SBezier *sbb, Vector *p) const;
+    bool PointOnThisAndCurve(const SBezier *sbb, double *ta, double *tb, Vector *p) const;
 
     Vector Start() const;
     Vector Finish() const;
@@ -101,7 +146,10 @@ public:
     void MakeNonrationalCubicInto(SBezierList *bl, double tolerance, int depth = 0) const;
 
     void AllIntersectionsWith(const SBezier *sbb, SPointList *spl) const;
+    void AllIntersectionsWith(const SBezier *sbb, std::vector<SBezierInter> *inters) const;
+    void AddCrossingTo(const SBezier *sbb, Vector p, SPointList *spl) const;
     void GetBoundingProjd(Vector u, Vector orig, double *umin, double *umax) const;
+    BBox GetBoundingBox() const;
     void Reverse();
 
     bool IsInPlane(Vector n, double d) const;
@@ -144,7 +192,9 @@ public:
     void MakePwlInto(SContour *sc, double chordTol=0) const;
     void GetBoundingProjd(Vector u, Vector orig, double *umin, double *umax) const;
 
-    static SBezierLoop FromCurves(SBezierList *spcl,
+    static SBezierLoop FromCurves(SBezierList *spcl, int first,
+                                  const SPointIndex *starts,
+                                  const SPointIndex *finishes,
                                   bool *allClosed, SEdge *errorAt);
 };
 
@@ -175,6 +225,7 @@ public:
                             bool *allClosed, SEdge *notClosedAt,
                             bool *allCoplanar, Vector *notCoplanarAt,
                             SBezierLoopSet *openContours);
+    void FindPathsFrom(SBezierList *sbl, SBezierLoopSet *openContours);
     void AddOpenPath(SBezier *sb);
     void Clear();
 };
@@ -222,6 +273,19 @@ public:
     void GetAxisAlignedBounding(Vector *ptMax, Vector *ptMin) const;
 };
 
+// The intersection curves of a Boolean, grouped by the surface that they trim
+// within each operand. Built once after the curves are generated, so that
+// trimming a surface doesn't have to scan every curve in the result.
+class SCurveIndex {
+public:
+    std::unordered_map<uint32_t, std::vector<hSCurve>> bySurfA;
+    std::unordered_map<uint32_t, std::vector<hSCurve>> bySurfB;
+
+    void Build(SShell *into);
+    const std::vector<hSCurve> *CurvesTrimming(hSSurface hs, bool opA) const;
+    void Clear();
+};
+
 // A segment of a curve by which a surface is trimmed: indicates which curve,
 // by its handle, and the starting and ending points of our segment of it.
 // The vector out points out of the surface; it, the surface outer normal,
@@ -298,9 +362,11 @@ public:
                                   Vector *surfn,
                                   uint32_t auxA,
                                   SShell *shell, SShell *sha, SShell *shb);
-    void FindChainAvoiding(SEdgeList *src, SEdgeList *dest, SPointList *avoid);
+    void FindChainAvoiding(SEdgeList *src, const SEdgeAdjacency *adj, int start,
+                           SEdgeList *dest, const SPointIndex *avoid);
     SSurface MakeCopyTrimAgainst(SShell *parent, SShell *a, SShell *b,
-                                    SShell *into, SSurface::CombineAs type, int dbg_index);
+                                    SShell *into, SSurface::CombineAs type, int dbg_index,
+                                    const SCurveIndex *interIndex);
     void TrimFromEdgeList(SEdgeList *el, bool asUv);
     void IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
                           SShell *into);
@@ -373,6 +439,42 @@ public:
     void Clear();
 };
 
+// A bounding volume hierarchy over axis-aligned boxes, each identified by
+// the order in which it was added; used to find the trim edges or surfaces
+// of a shell that lie near a point or segment without testing them all.
+class SBvh {
+public:
+    struct Node {
+        BBox    box;
+        int     left, right;    // children, or -1 for a leaf
+        int     first, count;   // range within order, for a leaf
+    };
+
+    std::vector<BBox>   boxes;
+    std::vector<int>    order;
+    std::vector<Node>   nodes;
+
+    void Clear();
+    int Add(const BBox &box);
+    void Build();
+    int BuildRange(int first, int count);
+    void FindOverlapping(const BBox &query, std::vector<int> *ids) const;
+    void FindOverlapping(const std::function<bool(const BBox &)> &overlaps,
+                         std::vector<int> *ids) const;
+};
+
+// A list of curves with a bounding volume hierarchy over them, to intersect
+// other curves against all of them (for example, everything in a workplane).
+class SBezierIndex {
+public:
+    const SBezierList   *list;
+    SBvh                bvh;
+
+    void Build(const SBezierList *sbl);
+    void AllIntersectionsWith(const SBezier *sb, std::vector<SBezierInter> *inters) const;
+    void Clear();
+};
+
 class SShell {
 public:
     IdList<SCurve,hSCurve>      curve;
@@ -380,6 +482,13 @@ public:
 
     bool                        booleanFailed;
 
+    // Built alongside the classifying BSPs during a Boolean, to accelerate
+    // ClassifyEdge: the trim edges of every surface (identified by surface
+    // and edge index), and the surfaces themselves.
+    SBvh                        edgeBvh;
+    std::vector<std::pair<int, int>> edgeBvhItems;
+    SBvh                        surfaceBvh;
+
     void MakeFromExtrusionOf(SBezierLoopSet *sbls, Vector t0, Vector t1,
                              RgbaColor color);
     bool CheckNormalAxisRelationship(SBezierLoopSet *sbls, Vector pt, Vector axis, double da, double dx);
@@ -393,9 +502,11 @@ public:
     void MakeFromIntersectionOf(SShell *a, SShell *b);
     void MakeFromBoolean(SShell *a, SShell *b, SSurface::CombineAs type);
     void CopyCurvesSplitAgainst(bool opA, SShell *agnst, SShell *into);
-    void CopySurfacesTrimAgainst(SShell *sha, SShell *shb, SShell *into, SSurface::CombineAs type);
+    void CopySurfacesTrimAgainst(SShell *sha, SShell *shb, SShell *into, SSurface::CombineAs type,
+                                 const SCurveIndex *interIndex);
     void MakeIntersectionCurvesAgainst(SShell *against, SShell *into);
     void MakeClassifyingBsps(SShell *useCurvesFrom);
+    void MakeClassifyingBvhs();
     void AllPointsIntersecting(Vector a, Vector b, List<SInter> *il,
                                 bool asSegment, bool trimmed, bool inclTangent);
     void MakeCoincidentEdgesInto(SSurface *proto, bool sameNormal,
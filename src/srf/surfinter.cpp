@@ -94,7 +94,7 @@ void SSurface::AddExactIntersectionCurve(SBezier *sb, SSurface *srfB,
         for(v = split.pts.First(); v; v = split.pts.NextAfter(v)) {
             if(prev) {
                 Vector e = (prev->p).Minus(v->p).WithMagnitude(0);
-                SS.nakedEdges.AddEdge((prev->p).Plus(e), (v->p).Minus(e));
+                SKernelContext::Current()->AddNakedEdge((prev->p).Plus(e), (v->p).Minus(e));
             }
             prev = v;
         }
@@ -424,8 +424,9 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
             spl.l.RemoveTagged();
 
             // Our chord tolerance is whatever the user specified
-            double maxtol = SS.ChordTolMm();
-            int maxsteps = max(300, SS.GetMaxSegments()*3);
+            const SKernelContext *ctx = SKernelContext::Current();
+            double maxtol = ctx->chordTol;
+            int maxsteps = max(300, ctx->maxSegments*3);
 
             // The curve starts at our starting point.
             SCurvePt padd = {};
@@ -481,7 +482,7 @@ void SSurface::IntersectAgainst(SSurface *b, SShell *agnstA, SShell *agnstB,
 
                 SPoint *sp;
                 for(sp = spl.l.First(); sp; sp = spl.l.NextAfter(sp)) {
-                    if((sp->p).OnLineSegment(start, npc, 2*SS.ChordTolMm())) {
+                    if((sp->p).OnLineSegment(start, npc, 2*maxtol)) {
                         sp->tag = 1;
                         a = maxsteps;
                         npc = sp->p;
@@ -483,7 +483,7 @@ void SContour::UvTriangulateInto(SMesh *m, SSurface *srf) {
                     bestEar = ear;
                     bestChordTol = tol;
                 }
-                if(bestChordTol < 0.1*SS.ChordTolMm()) {
+                if(bestChordTol < 0.1*SKernelContext::Current()->chordTol) {
                     break;
                 }
             }
@@ -566,8 +566,9 @@ void SSurface::MakeTriangulationGridInto(List<double> *l, double vs, double vf,
         worst = max(worst, pm2.DistanceToLine(ps, pf.Minus(ps)));
     }
 
-    double step = 1.0/SS.GetMaxSegments();
-    if( ((vf - vs) < step || worst < SS.ChordTolMm())
+    const SKernelContext *ctx = SKernelContext::Current();
+    double step = 1.0/ctx->maxSegments;
+    if( ((vf - vs) < step || worst < ctx->chordTol)
         && ((worst_twist > 0.999) || (depth > 3)) ) {
         l->Add(&vf);
     } else {
@@ -20,29 +20,38 @@ const double System::RANK_MAG_TOLERANCE = 1e-4;
 const double System::CONVERGE_TOLERANCE = (LENGTH_EPS/(1e2));
 
 bool System::WriteJacobian(int tag) {
+    std::vector<Equation *> eqs;
+    std::vector<hParam> params;
 
-    int j = 0;
     for(auto &p : param) {
-        if(j >= MAX_UNKNOWNS)
-            return false;
-
         if(p.tag != tag)
             continue;
-        mat.param[j] = p.h;
-        j++;
+        params.push_back(p.h);
     }
-    mat.n = j;
-
-    int i = 0;
-
     for(auto &e : eq) {
-        if(i >= MAX_UNKNOWNS) return false;
-
         if(e.tag != tag)
             continue;
+        eqs.push_back(&e);
+    }
+    return WriteJacobian(eqs, params);
+}
+
+bool System::WriteJacobian(const std::vector<Equation *> &eqs,
+                           const std::vector<hParam> &params)
+{
+    if(params.size() > MAX_UNKNOWNS || eqs.size() > MAX_UNKNOWNS)
+        return false;
+
+    int j;
+    mat.n = (int)params.size();
+    for(j = 0; j < mat.n; j++) {
+        mat.param[j] = params[j];
+    }
 
-        mat.eq[i] = e.h;
-        Expr *f   = e.e->DeepCopyWithParamsAsPointers(&param, &(SK.param));
+    int i = 0;
+    for(Equation *e : eqs) {
+        mat.eq[i] = e->h;
+        Expr *f   = e->e->DeepCopyWithParamsAsPointers(&param, &(SK.param));
         f = f->FoldConstants();
 
         // Hash table (61 bits) to accelerate generation of zero partials.
@@ -85,41 +94,497 @@ bool System::IsDragged(hParam p) {
     return false;
 }
 
+//-----------------------------------------------------------------------------
+// Write an equation that's a sum or difference of params and constants as
+// sum(coef[i]*p[i]) + k = 0, in at most two solver params, each with a
+// coefficient of 1 or -1. Params that aren't being solved for count as
+// constants. Returns false if the equation has any other form.
+//-----------------------------------------------------------------------------
+struct LinearForm {
+    int     n;
+    hParam  p[2];
+    double  coef[2];
+    double  k;
+};
+
+static bool AddToLinearForm(const Expr *e, double sign, ParamList *param,
+                            LinearForm *lf, int depth) {
+    if(depth > 8) return false;
+
+    switch(e->op) {
+        case Expr::Op::CONSTANT:
+            lf->k += sign*e->v;
+            return true;
+
+        case Expr::Op::PARAM: {
+            if(param->FindByIdNoOops(e->parh) == NULL) {
+                Param *known = SK.param.FindByIdNoOops(e->parh);
+                if(known == NULL) return false;
+                lf->k += sign*known->val;
+                return true;
+            }
+            for(int i = 0; i < lf->n; i++) {
+                if(lf->p[i] == e->parh) {
+                    lf->coef[i] += sign;
+                    return true;
+                }
+            }
+            if(lf->n == 2) return false;
+            lf->p[lf->n] = e->parh;
+            lf->coef[lf->n] = sign;
+            lf->n++;
+            return true;
+        }
+
+        case Expr::Op::PLUS:
+            return AddToLinearForm(e->a, sign, param, lf, depth + 1) &&
+                   AddToLinearForm(e->b, sign, param, lf, depth + 1);
+
+        case Expr::Op::MINUS:
+            return AddToLinearForm(e->a, sign, param, lf, depth + 1) &&
+                   AddToLinearForm(e->b, -sign, param, lf, depth + 1);
+
+        case Expr::Op::NEGATE:
+            return AddToLinearForm(e->a, -sign, param, lf, depth + 1);
+
+        default:
+            return false;
+    }
+}
+
+static bool GetLinearForm(const Expr *e, ParamList *param, LinearForm *lf) {
+    *lf = {};
+    if(!AddToLinearForm(e, 1.0, param, lf, 0)) return false;
+    for(int i = 0; i < lf->n; i++) {
+        if(fabs(lf->coef[i]) != 1.0) return false;
+    }
+    return lf->n > 0;
+}
+
+//-----------------------------------------------------------------------------
+// The params that are known to be affine functions of other params, as a
+// union-find forest; each param p has p = scale*parent + offset.
+//-----------------------------------------------------------------------------
+class ParamAliases {
+public:
+    std::unordered_map<uint32_t, Expr::Substitution> parent;
+
+    // Find the root of p's class, and p in terms of it; then point p
+    // straight at the root, so that later lookups are short.
+    Expr::Substitution Find(hParam p) {
+        auto it = parent.find(p.v);
+        if(it == parent.end()) return { p, 1.0, 0.0 };
+
+        Expr::Substitution up   = it->second;
+        Expr::Substitution root = Find(up.param);
+        Expr::Substitution r = { root.param, up.scale*root.scale,
+                                 up.scale*root.offset + up.offset };
+        parent[p.v] = r;
+        return r;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Eliminate the equations that are linear in one or two solver params with
+// unit coefficients (like a - b, a + b, or a - b - k), by replacing one param
+// with an affine function of the other everywhere. The params form classes
+// (as a union-find forest), and each one is replaced in terms of the root of
+// its class; a dragged param is kept in preference to the other. Then the
+// equations like a - k fix the value of the root of a's class, if it's not
+// fixed already.
+//
+// Each equation removed takes one unknown with it, so the DOF is unchanged;
+// an equation that contradicts the others stays, for the rank test or the
+// Newton solve to catch.
+//-----------------------------------------------------------------------------
 void System::SolveBySubstitution() {
-    for(auto &teq : eq) {
-        Expr *tex = teq.e;
+    ParamAliases aliases;
+    substituted.clear();
+    redundant.clear();
 
-        if(tex->op    == Expr::Op::MINUS &&
-           tex->a->op == Expr::Op::PARAM &&
-           tex->b->op == Expr::Op::PARAM)
-        {
-            hParam a = tex->a->parh;
-            hParam b = tex->b->parh;
-            if(!(param.FindByIdNoOops(a) && param.FindByIdNoOops(b))) {
-                // Don't substitute unless they're both solver params;
-                // otherwise it's an equation that can be solved immediately,
-                // or an error to flag later.
+    for(auto &teq : eq) {
+        LinearForm lf;
+        if(!GetLinearForm(teq.e, &param, &lf) || lf.n != 2) continue;
+
+        // c0*a + c1*b + k = 0, so a = s*b + o
+        hParam a = lf.p[0], b = lf.p[1];
+        double s = -lf.coef[0]*lf.coef[1],
+               o = -lf.coef[0]*lf.k;
+
+        // And in terms of the roots of their classes, ra = S*rb + O
+        Expr::Substitution sa = aliases.Find(a),
+                           sb = aliases.Find(b);
+        double S = sa.scale*s*sb.scale,
+               O = sa.scale*(s*sb.offset + o - sa.offset);
+
+        if(sa.param == sb.param) {
+            if(S == -1.0) {
+                // This determines the root, ra = O/2; leave it to be solved.
                 continue;
             }
+            // Otherwise the equation is implied by the others, or contradicts
+            // them. An implied plain a - b has always been dropped; anything
+            // else must stay in the main system, so that the rank test still
+            // sees the redundancy.
+            Expr *tex = teq.e;
+            if(tex->op    == Expr::Op::MINUS &&
+               tex->a->op == Expr::Op::PARAM &&
+               tex->b->op == Expr::Op::PARAM &&
+               fabs(O) < CONVERGE_TOLERANCE)
+            {
+                teq.tag = EQ_SUBSTITUTED;
+            } else {
+                redundant.insert(teq.h.v);
+            }
+            continue;
+        }
+
+        if(IsDragged(sa.param)) {
+            // A is being dragged, so A should stay, and B should go
+            aliases.parent[sb.param.v] = { sa.param, S, -S*O };
+        } else {
+            aliases.parent[sa.param.v] = { sb.param, S, O };
+        }
+        teq.tag = EQ_SUBSTITUTED;
+    }
+
+    std::unordered_map<uint32_t, double> fixed;
+    for(auto &teq : eq) {
+        if(teq.tag != 0) continue;
+
+        LinearForm lf;
+        if(!GetLinearForm(teq.e, &param, &lf) || lf.n != 1) continue;
+
+        // c0*a + k = 0, so a = -c0*k
+        Expr::Substitution sa = aliases.Find(lf.p[0]);
+        if(fixed.find(sa.param.v) != fixed.end()) {
+            // Let the rank test catch this one.
+            continue;
+        }
+        fixed[sa.param.v] = sa.scale*(-lf.coef[0]*lf.k - sa.offset);
+        teq.tag = EQ_SUBSTITUTED;
+    }
+
+    if(aliases.parent.empty() && fixed.empty()) return;
+
+    // Now replace each param with its root, rewriting every equation just
+    // once, and set the roots that are fixed.
+    for(auto &p : param) {
+        auto itf = fixed.find(p.h.v);
+        if(itf != fixed.end()) {
+            p.tag = VAR_FIXED;
+            p.val = itf->second;
+            continue;
+        }
+        if(aliases.parent.find(p.h.v) == aliases.parent.end()) continue;
+
+        Expr::Substitution sp = aliases.Find(p.h);
+        substituted[p.h.v] = sp;
+        p.tag = VAR_SUBSTITUTED;
+        p.substd = sp.param;
+    }
+    if(substituted.empty()) return;
+    for(auto &req : eq) {
+        req.e->Substitute(substituted);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Order the equations and params so that the system can be solved a small
+// block at a time. We find a maximum matching of equations to the params that
+// they reference, and set aside the part of the system that's structurally
+// under- or over-determined (the coarse Dulmage-Mendelsohn decomposition).
+// What's left is square, and its strongly connected components (by Tarjan's
+// algorithm, with an equation depending on the equations matched to its
+// params) are the blocks, which come out in an order that they can be solved.
+//
+// The searches use explicit stacks, since the system may be large.
+//-----------------------------------------------------------------------------
+class BlockDecomposition {
+public:
+    // The params that each equation references, as indices; set by caller.
+    std::vector<std::vector<int>> eqParams;
+
+    // The matched param of each equation and vice versa, or -1.
+    std::vector<int> eqMatch;
+    std::vector<int> paramMatch;
+    // The block of each equation, or -1 if not in the square part.
+    std::vector<int> eqBlock;
+    // The equations in each block, in the order to solve the blocks.
+    std::vector<std::vector<int>> blocks;
+
+    void Decompose(int nparams) {
+        int neqs = (int)eqParams.size();
+        eqMatch.assign(neqs, -1);
+        paramMatch.assign(nparams, -1);
+        visited.assign(nparams, 0);
+        stamp = 0;
+
+        // Most equations can be matched greedily; then look for augmenting
+        // paths for the rest.
+        int e;
+        for(e = 0; e < neqs; e++) {
+            for(int q : eqParams[e]) {
+                if(paramMatch[q] >= 0) continue;
+                paramMatch[q] = e;
+                eqMatch[e] = q;
+                break;
+            }
+        }
+        for(e = 0; e < neqs; e++) {
+            if(eqMatch[e] < 0) Augment(e);
+        }
+
+        std::vector<bool> square(neqs, false);
+        FindSquare(nparams, &square);
+        FindBlocks(square);
+    }
 
-            if(IsDragged(a)) {
-                // A is being dragged, so A should stay, and B should go
-                std::swap(a, b);
+private:
+    std::vector<int> visited;
+    int stamp;
+
+    bool Augment(int root) {
+        // Depth-first, for a path that alternates unmatched and matched
+        // edges and ends at an unmatched param.
+        std::vector<std::pair<int, size_t>> stack;
+        stack.emplace_back(root, 0);
+        stamp++;
+        while(!stack.empty()) {
+            int e = stack.back().first;
+            size_t k = stack.back().second;
+            if(k == eqParams[e].size()) {
+                stack.pop_back();
+                continue;
+            }
+            stack.back().second++;
+
+            int q = eqParams[e][k];
+            if(visited[q] == stamp) continue;
+            visited[q] = stamp;
+            if(paramMatch[q] < 0) {
+                // Found one, so flip each edge along it.
+                for(auto &se : stack) {
+                    int sq = eqParams[se.first][se.second - 1];
+                    paramMatch[sq] = se.first;
+                    eqMatch[se.first] = sq;
+                }
+                return true;
             }
+            stack.emplace_back(paramMatch[q], 0);
+        }
+        return false;
+    }
+
+    void FindSquare(int nparams, std::vector<bool> *square) {
+        int neqs = (int)eqParams.size();
+        int e, q;
 
-            for(auto &req : eq) {
-                req.e->Substitute(a, b); // A becomes B, B unchanged
+        std::vector<std::vector<int>> paramEqs(nparams);
+        for(e = 0; e < neqs; e++) {
+            for(int ep : eqParams[e]) paramEqs[ep].push_back(e);
+        }
+
+        // Anything reachable by an alternating path from an unmatched param
+        // is under-determined, and from an unmatched equation over-determined.
+        std::vector<bool> eqOut(neqs, false), paramOut(nparams, false);
+        std::vector<int> queue;
+        for(q = 0; q < nparams; q++) {
+            if(paramMatch[q] >= 0) continue;
+            paramOut[q] = true;
+            queue.push_back(q);
+        }
+        while(!queue.empty()) {
+            q = queue.back();
+            queue.pop_back();
+            for(int qe : paramEqs[q]) {
+                if(eqOut[qe]) continue;
+                eqOut[qe] = true;
+                int mq = eqMatch[qe];
+                if(mq >= 0 && !paramOut[mq]) {
+                    paramOut[mq] = true;
+                    queue.push_back(mq);
+                }
             }
-            for(auto &rp : param) {
-                if(rp.substd == a) {
-                    rp.substd = b;
+        }
+        for(e = 0; e < neqs; e++) {
+            if(eqMatch[e] >= 0) continue;
+            eqOut[e] = true;
+            queue.push_back(e);
+        }
+        while(!queue.empty()) {
+            e = queue.back();
+            queue.pop_back();
+            for(int ep : eqParams[e]) {
+                int me = paramMatch[ep];
+                if(me >= 0 && !eqOut[me]) {
+                    eqOut[me] = true;
+                    queue.push_back(me);
                 }
             }
-            Param *ptr = param.FindById(a);
-            ptr->tag = VAR_SUBSTITUTED;
-            ptr->substd = b;
+        }
 
-            teq.tag = EQ_SUBSTITUTED;
+        for(e = 0; e < neqs; e++) {
+            (*square)[e] = !eqOut[e];
+        }
+    }
+
+    void FindBlocks(const std::vector<bool> &square) {
+        int neqs = (int)eqParams.size();
+        std::vector<int> index(neqs, -1), low(neqs, 0);
+        std::vector<bool> onStack(neqs, false);
+        std::vector<int> component;
+        std::vector<std::pair<int, size_t>> stack;
+        int next = 0;
+
+        eqBlock.assign(neqs, -1);
+        blocks.clear();
+        for(int root = 0; root < neqs; root++) {
+            if(!square[root] || index[root] >= 0) continue;
+
+            stack.emplace_back(root, 0);
+            index[root] = low[root] = next++;
+            component.push_back(root);
+            onStack[root] = true;
+            while(!stack.empty()) {
+                int e = stack.back().first;
+                size_t k = stack.back().second;
+                if(k < eqParams[e].size()) {
+                    stack.back().second++;
+                    // This equation depends on the one matched to each of its
+                    // other params.
+                    int w = paramMatch[eqParams[e][k]];
+                    if(w < 0 || w == e || !square[w]) continue;
+                    if(index[w] < 0) {
+                        index[w] = low[w] = next++;
+                        component.push_back(w);
+                        onStack[w] = true;
+                        stack.emplace_back(w, 0);
+                    } else if(onStack[w]) {
+                        low[e] = std::min(low[e], index[w]);
+                    }
+                    continue;
+                }
+
+                stack.pop_back();
+                if(!stack.empty()) {
+                    int u = stack.back().first;
+                    low[u] = std::min(low[u], low[e]);
+                }
+                if(low[e] == index[e]) {
+                    std::vector<int> block;
+                    int w;
+                    do {
+                        w = component.back();
+                        component.pop_back();
+                        onStack[w] = false;
+                        eqBlock[w] = (int)blocks.size();
+                        block.push_back(w);
+                    } while(w != e);
+                    blocks.push_back(std::move(block));
+                }
+            }
+        }
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Solve as much of the system as we can a block at a time, each with its own
+// (small) Jacobian, in block-triangular order; so the params of each block
+// are determined by its equations, given the params of the blocks solved
+// before. A block whose Jacobian is singular is left for the main system,
+// where the rank test will report it; and if any block doesn't converge, then
+// we give up and leave everything to the main system.
+// Since each block is square, this has no effect on the DOF.
+//-----------------------------------------------------------------------------
+void System::SolveInBlocks() {
+    BlockDecomposition bd;
+    std::vector<Param *> params;
+    std::vector<Equation *> eqs;
+    std::unordered_map<uint32_t, int> paramIndex;
+
+    for(auto &p : param) {
+        if(p.tag != 0) continue;
+        paramIndex[p.h.v] = (int)params.size();
+        params.push_back(&p);
+    }
+    std::vector<hParam> found;
+    for(auto &e : eq) {
+        if(e.tag != 0) continue;
+        // Let the rank test catch these.
+        if(redundant.find(e.h.v) != redundant.end()) continue;
+
+        std::vector<int> adj;
+        found.clear();
+        e.e->ReferencedParams(&found);
+        for(hParam hp : found) {
+            auto it = paramIndex.find(hp.v);
+            if(it != paramIndex.end()) adj.push_back(it->second);
+        }
+        if(adj.empty()) continue;
+        eqs.push_back(&e);
+        bd.eqParams.push_back(std::move(adj));
+    }
+    bd.Decompose((int)params.size());
+
+    std::vector<bool> solved(params.size(), false);
+    std::vector<double> initial;
+    for(Param *p : params) {
+        initial.push_back(p->val);
+    }
+    std::vector<Equation *> blockEqs;
+    std::vector<hParam> blockParams;
+    for(size_t b = 0; b < bd.blocks.size(); b++) {
+        const std::vector<int> &block = bd.blocks[b];
+        if(block.size() > MAX_UNKNOWNS) continue;
+
+        // We can solve this block only if every block that it depends on
+        // was solved.
+        bool ready = true;
+        for(int e : block) {
+            for(int q : bd.eqParams[e]) {
+                if(solved[q]) continue;
+                int me = bd.paramMatch[q];
+                if(me >= 0 && bd.eqBlock[me] == (int)b) continue;
+                ready = false;
+            }
+        }
+        if(!ready) continue;
+
+        blockEqs.clear();
+        blockParams.clear();
+        for(int e : block) {
+            Param *p = params[bd.eqMatch[e]];
+            eqs[e]->tag = 1;
+            p->tag = 1;
+            blockEqs.push_back(eqs[e]);
+            blockParams.push_back(p->h);
+        }
+        if(!WriteJacobian(blockEqs, blockParams) || !SolveNonlinear(1)) {
+            // Errors in the blocks already solved may have carried forward
+            // and left this one far from a solution; so start over, and
+            // solve the whole thing at once.
+            for(Equation *e : eqs) {
+                e->tag = 0;
+            }
+            for(size_t q = 0; q < params.size(); q++) {
+                params[q]->tag = 0;
+                params[q]->val = initial[q];
+            }
+            return;
+        }
+        if(TestRank()) {
+            for(int e : block) {
+                solved[bd.eqMatch[e]] = true;
+            }
+            stats.blocks++;
+        } else {
+            for(int e : block) {
+                int q = bd.eqMatch[e];
+                eqs[e]->tag = 0;
+                params[q]->tag = 0;
+                params[q]->val = initial[q];
+            }
         }
     }
 }
@@ -285,6 +750,7 @@ bool System::NewtonSolve(int tag) {
     do {
         // And evaluate the Jacobian at our initial operating point.
         EvalJacobian();
+        stats.iterations++;
 
         if(!SolveLeastSquares()) break;
 
@@ -319,6 +785,152 @@ bool System::NewtonSolve(int tag) {
     return converged;
 }
 
+// Evaluate the functions at our operating point, and return the sum of their
+// squares; or infinity, if any of them is unreasonable.
+double System::EvalResiduals() {
+    double sum = 0;
+    for(int i = 0; i < mat.m; i++) {
+        double v = (mat.B.sym[i])->Eval();
+        mat.B.num[i] = v;
+        if(IsReasonable(v)) return INFINITY;
+        sum += v*v;
+    }
+    return sum;
+}
+
+//-----------------------------------------------------------------------------
+// A damped alternative to NewtonSolve, by Levenberg-Marquardt. We solve
+// (A*A' + mu*I) Z = B and step by A'*Z, with the same column scaling as
+// SolveLeastSquares; so with mu = 0 this is the Newton step, and as mu grows
+// the step gets shorter and turns towards steepest descent. A step is taken
+// only if it reduces the sum of the squared residuals, and mu is adjusted by
+// how well the linearization predicted that reduction.
+//-----------------------------------------------------------------------------
+bool System::LevenbergMarquardtSolve(int tag) {
+    int i, r, c;
+
+    std::vector<Param *> params;
+    for(c = 0; c < mat.n; c++) {
+        params.push_back(param.FindById(mat.param[c]));
+    }
+    std::vector<double> f(mat.m), rhs(mat.m), saved(mat.n), y(mat.n);
+
+    double cost = EvalResiduals();
+    if(cost == INFINITY) return false;
+
+    double mu = -1, nu = 2;
+    int iter = 0;
+    for(;;) {
+        bool converged = true;
+        for(i = 0; i < mat.m; i++) {
+            if(fabs(mat.B.num[i]) > CONVERGE_TOLERANCE) {
+                converged = false;
+                break;
+            }
+        }
+        if(converged) return true;
+        if(iter++ >= 50) return false;
+
+        EvalJacobian();
+        stats.iterations++;
+        for(c = 0; c < mat.n; c++) {
+            mat.scale[c] = IsDragged(mat.param[c]) ? 1/20.0 : 1;
+            for(r = 0; r < mat.m; r++) {
+                mat.A.num[r][c] *= mat.scale[c];
+            }
+        }
+        if(mu < 0) {
+            // Start out close to the Newton step.
+            double maxDiag = 0;
+            for(r = 0; r < mat.m; r++) {
+                double sum = 0;
+                for(i = 0; i < mat.n; i++) {
+                    sum += mat.A.num[r][i]*mat.A.num[r][i];
+                }
+                maxDiag = max(maxDiag, sum);
+            }
+            mu = max(1e-6*maxDiag, 1e-12);
+        }
+        for(i = 0; i < mat.m; i++) {
+            f[i] = mat.B.num[i];
+        }
+
+        bool accepted = false;
+        while(!accepted) {
+            if(mu > 1e20) {
+                // The step has shrunk to nothing, so we're stuck in a local
+                // minimum of the residual.
+                for(i = 0; i < mat.m; i++) {
+                    mat.B.num[i] = f[i];
+                }
+                return false;
+            }
+
+            for(r = 0; r < mat.m; r++) {
+                for(c = 0; c < mat.m; c++) {
+                    double sum = 0;
+                    for(i = 0; i < mat.n; i++) {
+                        sum += mat.A.num[r][i]*mat.A.num[c][i];
+                    }
+                    mat.AAt[r][c] = sum;
+                }
+                mat.AAt[r][r] += mu;
+                rhs[r] = f[r];
+                mat.Z[r] = 0;
+            }
+            SolveLinearSystem(mat.Z, mat.AAt, rhs.data(), mat.m);
+
+            // The step, and the reduction in the residual that the
+            // linearization predicts for it.
+            for(c = 0; c < mat.n; c++) {
+                double sum = 0;
+                for(i = 0; i < mat.m; i++) {
+                    sum += mat.A.num[i][c]*mat.Z[i];
+                }
+                y[c] = sum;
+                mat.X[c] = sum * mat.scale[c];
+            }
+            double predicted = 0;
+            for(r = 0; r < mat.m; r++) {
+                double ay = 0;
+                for(c = 0; c < mat.n; c++) {
+                    ay += mat.A.num[r][c]*y[c];
+                }
+                predicted += f[r]*f[r] - (f[r] - ay)*(f[r] - ay);
+            }
+
+            for(c = 0; c < mat.n; c++) {
+                saved[c] = params[c]->val;
+                params[c]->val -= mat.X[c];
+            }
+            double newCost = EvalResiduals();
+            double rho = (predicted > 0) ? (cost - newCost)/predicted : -1;
+            if(newCost < cost && rho > 0) {
+                accepted = true;
+                cost = newCost;
+                mu *= max(1/3.0, 1 - pow(2*rho - 1, 3));
+                nu = 2;
+            } else {
+                for(c = 0; c < mat.n; c++) {
+                    params[c]->val = saved[c];
+                }
+                mu *= nu;
+                nu *= 2;
+            }
+        }
+    }
+}
+
+bool System::SolveNonlinear(int tag) {
+    switch(algorithm) {
+        case Algorithm::NEWTON:
+            return NewtonSolve(tag);
+        case Algorithm::LEVENBERG_MARQUARDT:
+            return LevenbergMarquardtSolve(tag);
+    }
+    ssassert(false, "Unexpected solver algorithm");
+}
+
 void System::WriteEquationsExceptFor(hConstraint hc, Group *g) {
     // Generate all the equations from constraints in this group
     for(auto &con : SK.constraint) {
@@ -359,11 +971,19 @@ void System::FindWhichToRemoveToFixJacobian(Group *g, List<hConstraint> *bad, bo
     g->solved.timeout = false;
     int a;
 
-    for(a = 0; a < 2; a++) {
+    // Each attempt below redoes the substitution, which retags the params,
+    // sets the values of those that it fixes, and replaces the substitutions;
+    // but the caller writes back the solution that it already has, so keep
+    // that to restore afterwards.
+    std::vector<Param> savedParams(param.begin(), param.end());
+    std::unordered_map<uint32_t, Expr::Substitution> savedSubstituted = substituted;
+    std::unordered_set<uint32_t> savedRedundant = redundant;
+
+    for(a = 0; a < 2 && !g->solved.timeout; a++) {
         for(auto &con : SK.constraint) {
             if((GetMilliseconds() - time) > g->solved.findToFixTimeout) {
                 g->solved.timeout = true;
-                return;
+                break;
             }
 
             ConstraintBase *c = &con;
@@ -398,12 +1018,32 @@ void System::FindWhichToRemoveToFixJacobian(Group *g, List<hConstraint> *bad, bo
             }
         }
     }
+
+    int i = 0;
+    for(auto &p : param) {
+        p = savedParams[i++];
+    }
+    substituted = std::move(savedSubstituted);
+    redundant   = std::move(savedRedundant);
+}
+
+// Add the time since start to the total for a phase of the solve, and restart
+// the clock for the next one.
+static void EndPhase(double *start, double *total) {
+    double now = GetMillisecondsPrecise();
+    *total += now - *start;
+    *start = now;
 }
 
 SolveResult System::Solve(Group *g, int *rank, int *dof, List<hConstraint> *bad,
                           bool andFindBad, bool andFindFree, bool forceDofCheck)
 {
+    stats = {};
+    double start = GetMillisecondsPrecise();
+
     WriteEquationsExceptFor(Constraint::NO_CONSTRAINT, g);
+    stats.equations = eq.n;
+    EndPhase(&start, &stats.writeEquationsMs);
 
     int i;
     bool rankOk;
@@ -426,66 +1066,56 @@ SolveResult System::Solve(Group *g, int *rank, int *dof, List<hConstraint> *bad,
     // to succeed even on overdefined systems, which will fail later.
     if(!forceDofCheck) {
         SolveBySubstitution();
+        stats.substituted = (int)substituted.size();
     }
+    EndPhase(&start, &stats.substitutionMs);
 
-    // Before solving the big system, see if we can find any equations that
-    // are soluble alone. This can be a huge speedup. We don't know whether
-    // the system is consistent yet, but if it isn't then we'll catch that
-    // later.
-    int alone = 1;
-    for(auto &e : eq) {
-        if(e.tag != 0)
-            continue;
-
-        hParam hp = e.e->ReferencedParams(&param);
-        if(hp == Expr::NO_PARAMS) continue;
-        if(hp == Expr::MULTIPLE_PARAMS) continue;
-
-        Param *p = param.FindById(hp);
-        if(p->tag != 0) continue; // let rank test catch inconsistency
-
-        e.tag  = alone;
-        p->tag = alone;
-        WriteJacobian(alone);
-        if(!NewtonSolve(alone)) {
-            // We don't do the rank test, so let's arbitrarily return
-            // the DIDNT_CONVERGE result here.
-            rankOk = true;
-            // Failed to converge, bail out early
-            goto didnt_converge;
-        }
-        alone++;
-    }
+    // Before solving the big system, solve whatever we can as a sequence of
+    // small ones. This can be a huge speedup. We don't know whether the system
+    // is consistent yet, but if it isn't then we'll catch that later.
+    SolveInBlocks();
+    EndPhase(&start, &stats.blocksMs);
 
     // Now write the Jacobian for what's left, and do a rank test; that
     // tells us if the system is inconsistently constrained.
     if(!WriteJacobian(0)) {
+        EndPhase(&start, &stats.jacobianMs);
         return SolveResult::TOO_MANY_UNKNOWNS;
     }
+    stats.rows    = mat.m;
+    stats.columns = mat.n;
+    EndPhase(&start, &stats.jacobianMs);
 
     rankOk = TestRank(rank);
+    EndPhase(&start, &stats.rankMs);
 
     // And do the leftovers as one big system
-    if(!NewtonSolve(0)) {
+    if(!SolveNonlinear(0)) {
+        EndPhase(&start, &stats.solveMs);
         goto didnt_converge;
     }
+    EndPhase(&start, &stats.solveMs);
 
     rankOk = TestRank(rank);
+    EndPhase(&start, &stats.rankMs);
     if(!rankOk) {
         if(andFindBad) FindWhichToRemoveToFixJacobian(g, bad, forceDofCheck);
+        EndPhase(&start, &stats.findBadMs);
     } else {
         // This is not the full Jacobian, but any substitutions or single-eq
         // solves removed one equation and one unknown, therefore no effect
         // on the number of DOF.
         if(dof) *dof = CalculateDof();
         MarkParamsFree(andFindFree);
+        EndPhase(&start, &stats.rankMs);
     }
     // System solved correctly, so write the new values back in to the
     // main parameter table.
     for(auto &p : param) {
         double val;
         if(p.tag == VAR_SUBSTITUTED) {
-            val = param.FindById(p.substd)->val;
+            const Expr::Substitution &sp = substituted[p.h.v];
+            val = sp.scale*param.FindById(sp.param)->val + sp.offset;
         } else {
             val = p.val;
         }
@@ -522,6 +1152,7 @@ didnt_converge:
 SolveResult System::SolveRank(Group *g, int *rank, int *dof, List<hConstraint> *bad,
                               bool andFindBad, bool andFindFree)
 {
+    stats = {};
     WriteEquationsExceptFor(Constraint::NO_CONSTRAINT, g);
 
     // All params and equations are assigned to group zero.
@@ -549,6 +1180,8 @@ void System::Clear() {
     param.Clear();
     eq.Clear();
     dragged.Clear();
+    substituted.clear();
+    redundant.clear();
 }
 
 void System::MarkParamsFree(bool find) {
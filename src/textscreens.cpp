@@ -89,6 +89,10 @@ void TextWindow::ScreenShowConfiguration(int link, uint32_t v) {
 void TextWindow::ScreenShowEditView(int link, uint32_t v) {
     SS.TW.GoToScreen(Screen::EDIT_VIEW);
 }
+void TextWindow::ScreenShowRegenProfile(int link, uint32_t v) {
+    SS.TW.GoToScreen(Screen::REGEN_PROFILE);
+    SS.TW.shown.group = {};
+}
 void TextWindow::ScreenGoToWebsite(int link, uint32_t v) {
     Platform::OpenInBrowser("http://solvespace.com/txtlink");
 }
@@ -161,6 +165,8 @@ void TextWindow::ShowListOfGroups() {
         &(TextWindow::ScreenShowListOfStyles),
         &(TextWindow::ScreenShowEditView),
         &(TextWindow::ScreenShowConfiguration));
+    Printf(false, "  %Fl%Ll%fregeneration profile%E",
+        &(TextWindow::ScreenShowRegenProfile));
 }
 
 
@@ -594,6 +600,85 @@ void TextWindow::ShowGroupSolveInfo() {
     }
 }
 
+//-----------------------------------------------------------------------------
+// The screen that shows how long each group took to solve and to generate its
+// mesh, the last time that it was regenerated; and, for a selected group,
+// where within the solver that time went.
+//-----------------------------------------------------------------------------
+void TextWindow::ScreenRegenProfileGroup(int link, uint32_t v) {
+    SS.TW.shown.group.v = v;
+}
+void TextWindow::ScreenRegenerateAll(int link, uint32_t v) {
+    SS.GenerateAll(SolveSpaceUI::Generate::ALL);
+}
+void TextWindow::ShowRegenProfile() {
+    Printf(true, "%FtREGENERATION PROFILE%E");
+    Printf(false, "%Ft group-name           solve ms  mesh ms  iter%E");
+
+    double solveMs = 0, meshMs = 0;
+    int iterations = 0;
+    bool backgroundParity = false, anyStale = false;
+    for(hGroup hg : SK.groupOrder) {
+        Group *g = SK.GetGroup(hg);
+
+        std::string s = g->DescriptionString();
+        if(s.length() > 20) s = s.substr(0, 19) + "~";
+        double groupMeshMs = g->profile.meshMs + g->profile.booleanMs;
+        // Groups that weren't regenerated last time keep their older times;
+        // show those dimmed, and leave them out of the total.
+        Printf(false, g->profile.stale ? "%Bp %Fl%Ll%D%f%s%E%Fh%s%E" :
+                                         "%Bp %Fl%Ll%D%f%s%E%s",
+               backgroundParity ? 'd' : 'a',
+               g->h.v, (&TextWindow::ScreenRegenProfileGroup), s.c_str(),
+               ssprintf("%*s %8.1f %8.1f %5d", (int)(20 - s.length()), "",
+                        g->profile.solveMs, groupMeshMs,
+                        g->profile.solve.iterations).c_str());
+        backgroundParity = !backgroundParity;
+
+        if(g->profile.stale) {
+            anyStale = true;
+            continue;
+        }
+        solveMs    += g->profile.solveMs;
+        meshMs     += groupMeshMs;
+        iterations += g->profile.solve.iterations;
+    }
+    Printf(false, "%Ft total%E%s",
+           ssprintf("%15s %8.1f %8.1f %5d", "", solveMs, meshMs, iterations).c_str());
+    if(anyStale) {
+        Printf(false, " Dimmed groups weren't regenerated last time, and aren't");
+        Printf(false, " in the total.");
+    }
+
+    Group *g = SK.group.FindByIdNoOops(shown.group);
+    if(g) {
+        const SolveStats &st = g->profile.solve;
+        auto phase = [&](const char *what, double ms, const std::string &detail) {
+            Printf(false, "   %s", ssprintf("%-18s %8.2f ms  %s", what, ms,
+                                            detail.c_str()).c_str());
+        };
+
+        Printf(true, "%FtGROUP   %E%s", g->DescriptionString().c_str());
+        if(g->profile.stale) {
+            Printf(false, "   (not regenerated last time; these times are older)");
+        }
+        phase("write equations",  st.writeEquationsMs, ssprintf("%d eqs", st.equations));
+        phase("substitution",     st.substitutionMs,   ssprintf("%d params", st.substituted));
+        phase("blocks",           st.blocksMs,         ssprintf("%d solved", st.blocks));
+        phase("jacobian",         st.jacobianMs,       ssprintf("%d x %d", st.rows, st.columns));
+        phase("rank and dof",     st.rankMs,           "");
+        phase("nonlinear solve",  st.solveMs,          ssprintf("%d iter", st.iterations));
+        phase("find bad",         st.findBadMs,        "");
+        phase("mesh",             g->profile.meshMs,    "");
+        phase("boolean",          g->profile.booleanMs, "");
+    } else {
+        Printf(true, "%FdClick on a group to see where its time went.");
+    }
+
+    Printf(true, "  %Fl%Ll%fregenerate all%E",
+        &(TextWindow::ScreenRegenerateAll));
+}
+
 //-----------------------------------------------------------------------------
 // When we're stepping a dimension. User specifies the finish value, and
 // how many steps to take in between current and finish, re-solving each
@@ -758,6 +843,7 @@ void TextWindow::EditControlDone(std::string s) {
                     if(g->GetNumConstraints() == 0) {
                         double copies = (g->skipFirst) ? (ev + 1) : ev;
                         SK.GetParam(g->h.param(3))->val = PI/(2*copies);
+                        g->InvalidateCopyTransforms();
                     }
                 }
 
@@ -570,6 +570,7 @@ void TextWindow::Show() {
             case Screen::PASTE_TRANSFORMED:  ShowPasteTransformed(); break;
             case Screen::EDIT_VIEW:          ShowEditView();         break;
             case Screen::TANGENT_ARC:        ShowTangentArc();       break;
+            case Screen::REGEN_PROFILE:      ShowRegenProfile();     break;
         }
     }
     Printf(false, "");
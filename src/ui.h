@@ -270,7 +270,8 @@ public:
         STYLE_INFO          = 6,
         PASTE_TRANSFORMED   = 7,
         EDIT_VIEW           = 8,
-        TANGENT_ARC         = 9
+        TANGENT_ARC         = 9,
+        REGEN_PROFILE       = 10
     };
     typedef struct {
         Screen  screen;
@@ -387,6 +388,7 @@ public:
     void ShowPasteTransformed();
     void ShowEditView();
     void ShowTangentArc();
+    void ShowRegenProfile();
     // Special screen, based on selection
     void DescribeSelection();
 
@@ -433,6 +435,9 @@ public:
 
     static void ScreenShowConfiguration(int link, uint32_t v);
     static void ScreenShowEditView(int link, uint32_t v);
+    static void ScreenShowRegenProfile(int link, uint32_t v);
+    static void ScreenRegenProfileGroup(int link, uint32_t v);
+    static void ScreenRegenerateAll(int link, uint32_t v);
     static void ScreenGoToWebsite(int link, uint32_t v);
 
     static void ScreenChangeFixExportColors(int link, uint32_t v);
@@ -491,6 +496,7 @@ public:
     static void ScreenChangeGCodeParameter(int link, uint32_t v);
     static void ScreenChangeAutosaveInterval(int link, uint32_t v);
     static void ScreenChangeFindConstraintTimeout(int link, uint32_t v);
+    static void ScreenChangeSolverAlgorithm(int link, uint32_t v);
     static void ScreenChangeStyleName(int link, uint32_t v);
     static void ScreenChangeStyleMetric(int link, uint32_t v);
     static void ScreenChangeStyleTextAngle(int link, uint32_t v);
@@ -705,6 +711,8 @@ public:
     void RemoveConstraintsForPointBeingDeleted(hEntity hpt);
     void FixConstraintsForRequestBeingDeleted(hRequest hr);
     void FixConstraintsForPointBeingDeleted(hEntity hpt);
+    void FixConstraintsForPointsBeingDeleted(const std::vector<hEntity> &hpts);
+    void RemoveConstraintsForTaggedRequests();
     void EditConstraint(hConstraint constraint);
 
     // A selected entity.
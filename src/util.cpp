@@ -35,6 +35,70 @@ std::string SolveSpace::ssprintf(const char *fmt, ...)
     return result;
 }
 
+void SolveSpace::vssappendf(std::string *out, const char *fmt, va_list va)
+{
+    va_list vb;
+    char tmp[256];
+
+    va_copy(vb, va);
+    int size = vsnprintf(tmp, sizeof(tmp), fmt, vb);
+    ssassert(size >= 0, "vsnprintf could not encode string");
+    va_end(vb);
+
+    if(size < (int)sizeof(tmp)) {
+        out->append(tmp, (size_t)size);
+    } else {
+        size_t at = out->size();
+        out->resize(at + size + 1);
+        vsnprintf(&(*out)[at], size + 1, fmt, va);
+        out->resize(at + size);
+    }
+}
+
+// Append v as printf's "%.*f" would, but without going through printf for
+// the usual case of a moderately sized finite value. The scaled product
+// isn't exact, but its rounding error is (from the fma), so we can still
+// round the exact value correctly; exact ties, which printf breaks to even,
+// are rare enough to just hand to snprintf.
+void SolveSpace::AppendFixed(std::string *out, double v, int decimals)
+{
+    static const double scales[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5,
+                                      1e6, 1e7, 1e8, 1e9, 1e10 };
+    ssassert(decimals >= 0 && decimals <= 10, "Unexpected precision");
+
+    double a = fabs(v), scale = scales[decimals];
+    double p = a * scale;
+    if(p < 4503599627370496.0) { // 2^52, and false for NaN
+        double e = fma(a, scale, -p);
+        double ip = floor(p);
+        double d = (p - ip) - 0.5 + e;
+        if(d != 0.0) {
+            uint64_t q = (uint64_t)ip + (d > 0 ? 1 : 0);
+            char tmp[32];
+            char *s = tmp + sizeof(tmp);
+            for(int i = 0; i < decimals; i++) {
+                *--s = (char)('0' + q % 10);
+                q /= 10;
+            }
+            if(decimals > 0) *--s = '.';
+            do {
+                *--s = (char)('0' + q % 10);
+                q /= 10;
+            } while(q);
+            if(std::signbit(v)) *--s = '-';
+            out->append(s, (size_t)(tmp + sizeof(tmp) - s));
+            return;
+        }
+    }
+    char tmp[512];
+    int size = snprintf(tmp, sizeof(tmp), "%.*f", decimals, v);
+    if(size >= 0 && size < (int)sizeof(tmp)) {
+        out->append(tmp, (size_t)size);
+    } else {
+        *out += ssprintf("%.*f", decimals, v);
+    }
+}
+
 char32_t utf8_iterator::operator*()
 {
     const uint8_t *it = (const uint8_t*) this->p;
@@ -63,6 +127,12 @@ int64_t SolveSpace::GetMilliseconds()
     return std::chrono::duration_cast<std::chrono::milliseconds>(timestamp).count();
 }
 
+double SolveSpace::GetMillisecondsPrecise()
+{
+    auto timestamp = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double, std::milli>(timestamp).count();
+}
+
 void SolveSpace::MakeMatrix(double *mat,
                             double a11, double a12, double a13, double a14,
                             double a21, double a22, double a23, double a24,
@@ -0,0 +1,107 @@
+#include "harness.h"
+
+// In these sketches, each point of a strip of equilateral triangles is at
+// distance 10 from the two before it, so it can be solved on its own once
+// they are; the first point is dragged to the origin, and the second is
+// horizontal from it. The strip is requests 4 to 9, in group 2.
+static const hGroup SKETCH = { 2 };
+
+static Vector PointOf(uint32_t request) {
+    return SK.GetEntity(hRequest{request}.entity(0))->PointGetNum();
+}
+
+static void MovePoint(uint32_t request, double du, double dv) {
+    EntityBase *e = SK.GetEntity(hRequest{request}.entity(0));
+    SK.GetParam(e->param[0])->val += du;
+    SK.GetParam(e->param[1])->val += dv;
+}
+
+static bool IsRemoved(Group *g, uint32_t constraint) {
+    for(hConstraint hc : g->solved.remove) {
+        if(hc.v == constraint) return true;
+    }
+    return false;
+}
+
+// The DOF from the rank of the whole system at once, with nothing solved in
+// blocks or by substitution first.
+static int MonolithicDof(hGroup hg) {
+    int rank;
+    if(SS.TestRankForGroup(hg, &rank) != SolveResult::OKAY) return -1;
+    return SS.sys.mat.n - rank;
+}
+
+TEST_CASE(strip) {
+    CHECK_LOAD("strip.slvs");
+    Group *g = SK.GetGroup(SKETCH);
+    CHECK_TRUE(g->solved.how == SolveResult::OKAY);
+    CHECK_TRUE(g->profile.solve.blocks == 8);
+    CHECK_TRUE(g->profile.solve.rows == 0);
+
+    MovePoint(6, 0.5, -0.5);
+    MovePoint(7, -0.5, 0.5);
+    MovePoint(8, 0.5, 0.5);
+    MovePoint(9, -0.5, -0.5);
+    SS.MarkGroupDirty(SKETCH);
+    SS.GenerateAll(SolveSpaceUI::Generate::ALL);
+    g = SK.GetGroup(SKETCH);
+    CHECK_TRUE(g->solved.how == SolveResult::OKAY);
+    CHECK_TRUE(g->profile.solve.blocks > 0);
+    CHECK_TRUE(g->profile.solve.rows == 0);
+
+    double h = 10 * sqrt(3) / 2;
+    CHECK_EQ_EPS(PointOf(4).x, 0);
+    CHECK_EQ_EPS(PointOf(4).y, 0);
+    CHECK_EQ_EPS(PointOf(5).x, 10);
+    CHECK_EQ_EPS(PointOf(5).y, 0);
+    CHECK_EQ_EPS(PointOf(6).x, 5);
+    CHECK_EQ_EPS(PointOf(6).y, h);
+    CHECK_EQ_EPS(PointOf(7).x, 15);
+    CHECK_EQ_EPS(PointOf(7).y, h);
+    CHECK_EQ_EPS(PointOf(8).x, 10);
+    CHECK_EQ_EPS(PointOf(8).y, 2 * h);
+    CHECK_EQ_EPS(PointOf(9).x, 20);
+    CHECK_EQ_EPS(PointOf(9).y, 2 * h);
+}
+
+TEST_CASE(strip_dof) {
+    CHECK_LOAD("strip.slvs");
+    Group *g = SK.GetGroup(SKETCH);
+    CHECK_TRUE(g->solved.dof == 0);
+    CHECK_TRUE(MonolithicDof(SKETCH) == 0);
+
+    // The last point is only at distance 10 from one other, so it's free to
+    // move on a circle; that's left for the main system.
+    CHECK_LOAD("strip_free.slvs");
+    g = SK.GetGroup(SKETCH);
+    CHECK_TRUE(g->solved.how == SolveResult::OKAY);
+    CHECK_TRUE(g->profile.solve.blocks > 0);
+    CHECK_TRUE(g->profile.solve.rows > 0);
+    CHECK_TRUE(g->solved.dof == 1);
+    CHECK_TRUE(MonolithicDof(SKETCH) == 1);
+}
+
+TEST_CASE(strip_redundant) {
+    // The last point is at distance 10 from the one before, and from another
+    // point that's coincident with it; so its block is square, but singular.
+    CHECK_LOAD("strip_redundant.slvs");
+    Group *g = SK.GetGroup(SKETCH);
+    CHECK_TRUE(g->solved.how == SolveResult::REDUNDANT_OKAY);
+    CHECK_TRUE(g->profile.solve.blocks > 0);
+    CHECK_TRUE(g->solved.remove.n == 3);
+    CHECK_TRUE(IsRemoved(g, 11));
+    CHECK_TRUE(IsRemoved(g, 12));
+    CHECK_TRUE(IsRemoved(g, 13));
+
+    int rank;
+    CHECK_TRUE(SS.TestRankForGroup(SKETCH, &rank) == SolveResult::REDUNDANT_OKAY);
+}
+
+TEST_CASE(strip_inconsistent) {
+    // As above, but at distance 12 from the coincident point.
+    CHECK_LOAD("strip_inconsistent.slvs");
+    Group *g = SK.GetGroup(SKETCH);
+    CHECK_TRUE(g->solved.how == SolveResult::DIDNT_CONVERGE);
+    CHECK_TRUE(IsRemoved(g, 11));
+    CHECK_TRUE(IsRemoved(g, 13));
+}
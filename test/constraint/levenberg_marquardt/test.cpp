@@ -0,0 +1,143 @@
+#include "harness.h"
+
+// The sketches of the other constraint tests, with the number of iterations
+// that each algorithm takes over all of their groups, after Perturb(); so a
+// change that makes either converge faster or slower shows up here.
+static const struct {
+    const char *fixture;
+    int         newtonIterations;
+    int         lmIterations;
+} CORPUS[] = {
+    { "../angle/free_in_3d.slvs",                     2, 2 },
+    { "../angle/normal.slvs",                         2, 2 },
+    { "../angle/reference.slvs",                      1, 0 },
+    { "../angle/reference_free_in_3d.slvs",           1, 0 },
+    { "../angle/skew.slvs",                           1, 1 },
+    { "../arc_line_tangent/normal.slvs",              2, 2 },
+    { "../at_midpoint/line_plane_free_in_3d.slvs",    1, 1 },
+    { "../at_midpoint/line_plane_normal.slvs",        1, 0 },
+    { "../at_midpoint/line_pt_free_in_3d.slvs",       1, 2 },
+    { "../at_midpoint/line_pt_normal.slvs",           1, 2 },
+    { "../comment/normal.slvs",                       1, 0 },
+    { "../cubic_line_tangent/free_in_3d.slvs",        2, 2 },
+    { "../cubic_line_tangent/normal.slvs",            2, 2 },
+    { "../curve_curve_tangent/arc_arc.slvs",          2, 2 },
+    { "../curve_curve_tangent/arc_cubic.slvs",        2, 2 },
+    { "../diameter/normal.slvs",                      2, 0 },
+    { "../diameter/reference.slvs",                   1, 0 },
+    { "../eq_len_pt_line_d/normal.slvs",              2, 2 },
+    { "../eq_pt_ln_distances/normal.slvs",            1, 1 },
+    { "../equal_angle/normal.slvs",                   2, 2 },
+    { "../equal_angle/normal_old_version.slvs",       2, 2 },
+    { "../equal_angle/other.slvs",                    2, 2 },
+    { "../equal_length_lines/normal.slvs",            1, 1 },
+    { "../equal_line_arc_len/normal.slvs",            2, 2 },
+    { "../equal_line_arc_len/pi.slvs",                2, 2 },
+    { "../equal_line_arc_len/tau.slvs",               2, 2 },
+    { "../equal_radius/normal.slvs",                  1, 0 },
+    { "../horizontal/line.slvs",                      1, 0 },
+    { "../horizontal/pt_pt.slvs",                     1, 0 },
+    { "../length_difference/normal.slvs",             1, 2 },
+    { "../length_difference/reference.slvs",          1, 0 },
+    { "../length_ratio/normal.slvs",                  2, 2 },
+    { "../length_ratio/reference.slvs",               1, 0 },
+    { "../parallel/free_in_3d.slvs",                  1, 2 },
+    { "../parallel/normal.slvs",                      2, 2 },
+    { "../perpendicular/normal.slvs",                 1, 1 },
+    { "../points_coincident/free_in_3d.slvs",         1, 0 },
+    { "../points_coincident/normal.slvs",             1, 0 },
+    { "../proj_pt_distance/normal.slvs",              1, 2 },
+    { "../proj_pt_distance/reference.slvs",           1, 0 },
+    { "../pt_face_distance/normal.slvs",              4, 4 },
+    { "../pt_face_distance/reference.slvs",           4, 3 },
+    { "../pt_in_plane/normal.slvs",                   1, 1 },
+    { "../pt_line_distance/extended.slvs",            1, 2 },
+    { "../pt_line_distance/free_in_3d.slvs",          1, 1 },
+    { "../pt_line_distance/normal.slvs",              1, 2 },
+    { "../pt_line_distance/reference.slvs",           1, 0 },
+    { "../pt_on_circle/negative_dia.slvs",            1, 2 },
+    { "../pt_on_circle/normal.slvs",                  1, 2 },
+    { "../pt_on_face/normal.slvs",                    4, 5 },
+    { "../pt_on_line/left_free_in_3d.slvs",           1, 2 },
+    { "../pt_on_line/normal.slvs",                    2, 2 },
+    { "../pt_on_line/right_free_in_3d.slvs",          2, 2 },
+    { "../pt_plane_distance/normal.slvs",             1, 1 },
+    { "../pt_plane_distance/reference.slvs",          1, 0 },
+    { "../pt_pt_distance/free_in_3d.slvs",            1, 2 },
+    { "../pt_pt_distance/normal.slvs",                1, 2 },
+    { "../pt_pt_distance/reference.slvs",             1, 0 },
+    { "../same_orientation/normal.slvs",              4, 3 },
+    { "../same_orientation/same_group.slvs",          3, 3 },
+    { "../symmetric/free_in_3d.slvs",                 1, 2 },
+    { "../symmetric/normal.slvs",                     1, 2 },
+    { "../symmetric_horiz/normal.slvs",               1, 0 },
+    { "../symmetric_line/normal.slvs",                2, 2 },
+    { "../symmetric_vert/normal.slvs",                1, 0 },
+    { "../vertical/line.slvs",                        1, 0 },
+    { "../vertical/pt_pt.slvs",                       1, 0 },
+    { "../where_dragged/free_in_3d.slvs",             1, 0 },
+    { "../where_dragged/normal.slvs",                 1, 0 },
+    { "../blocks/strip.slvs",                         9, 8 },
+    { "../substitution/chain.slvs",                   3, 1 },
+};
+
+// Move the params of the requests off their solved values, the same way
+// each time, so that the solver has some work to do.
+static void Perturb() {
+    int i = 0;
+    for(Param &p : SK.param) {
+        Request *r = SK.request.FindByIdNoOops(p.h.request());
+        if(r == NULL || r->group == Group::HGROUP_REFERENCES) continue;
+        p.val += 0.01 * ((i++ % 5) - 2);
+    }
+}
+
+static void SolveWith(System::Algorithm algorithm) {
+    Perturb();
+    SS.solverAlgorithm = algorithm;
+    SS.GenerateAll(SolveSpaceUI::Generate::ALL);
+}
+
+static int TotalIterations() {
+    int iterations = 0;
+    for(hGroup hg : SK.groupOrder) {
+        iterations += SK.GetGroup(hg)->profile.solve.iterations;
+    }
+    return iterations;
+}
+
+TEST_CASE(corpus) {
+    for(const auto &entry : CORPUS) {
+        const char *fixture = entry.fixture;
+        CHECK_LOAD(fixture);
+        SolveWith(System::Algorithm::NEWTON);
+        CHECK_TRUE(TotalIterations() == entry.newtonIterations);
+        std::vector<SolveResult> how;
+        std::vector<int> dof;
+        for(hGroup hg : SK.groupOrder) {
+            Group *g = SK.GetGroup(hg);
+            how.push_back(g->solved.how);
+            dof.push_back(g->solved.dof);
+        }
+        IdList<Param,hParam> newton = {};
+        SK.param.DeepCopyInto(&newton);
+
+        CHECK_LOAD(fixture);
+        SolveWith(System::Algorithm::LEVENBERG_MARQUARDT);
+        CHECK_TRUE(TotalIterations() == entry.lmIterations);
+        bool allFixed = true;
+        for(int i = 0; i < SK.groupOrder.n; i++) {
+            Group *g = SK.GetGroup(SK.groupOrder[i]);
+            CHECK_TRUE(g->solved.how == how[i]);
+            CHECK_TRUE(g->solved.dof == dof[i]);
+            if(dof[i] != 0) allFixed = false;
+        }
+        // Where the solution is unique, both should find it.
+        if(allFixed) {
+            for(Param &p : SK.param) {
+                CHECK_EQ_EPS(p.val, newton.FindById(p.h)->val);
+            }
+        }
+        newton.Clear();
+    }
+}
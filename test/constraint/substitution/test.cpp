@@ -0,0 +1,112 @@
+#include "harness.h"
+
+// In these sketches, the datum points P and Q are in group 2, and the points
+// A, B, C and D (requests 6 to 9) are constrained in group 3.
+static const hGroup SKETCH = { 3 };
+
+static Vector PointOf(uint32_t request) {
+    return SK.GetEntity(hRequest{request}.entity(0))->PointGetNum();
+}
+
+static void MovePoint(uint32_t request, double du, double dv) {
+    EntityBase *e = SK.GetEntity(hRequest{request}.entity(0));
+    SK.GetParam(e->param[0])->val += du;
+    SK.GetParam(e->param[1])->val += dv;
+}
+
+static bool IsRemoved(Group *g, uint32_t constraint) {
+    for(hConstraint hc : g->solved.remove) {
+        if(hc.v == constraint) return true;
+    }
+    return false;
+}
+
+// Solve the group again as if its DOF check had passed earlier, which is when
+// the solver eliminates what it can by substitution first.
+static Group *SolveWithSubstitution() {
+    Group *g = SK.GetGroup(SKETCH);
+    g->dofCheckOk = true;
+    SS.MarkGroupDirty(g->h);
+    SS.GenerateAll(SolveSpaceUI::Generate::ALL);
+    return SK.GetGroup(SKETCH);
+}
+
+TEST_CASE(chain) {
+    // A is vertical from P and 4 from it; B, C and D follow from A by a
+    // chain of symmetric constraints, as equations like a + b and a - b.
+    CHECK_LOAD("chain.slvs");
+    MovePoint(7, 1, 1);
+    MovePoint(8, -1, 1);
+    MovePoint(9, 1, -1);
+    Group *g = SolveWithSubstitution();
+    CHECK_TRUE(g->solved.how == SolveResult::OKAY);
+    CHECK_TRUE(g->solved.dof == 0);
+    CHECK_TRUE(g->profile.solve.substituted == 6);
+    CHECK_EQ_EPS(PointOf(6).x, 3);
+    CHECK_EQ_EPS(PointOf(6).y, 9);
+    CHECK_EQ_EPS(PointOf(7).x, -3);
+    CHECK_EQ_EPS(PointOf(7).y, 9);
+    CHECK_EQ_EPS(PointOf(8).x, -3);
+    CHECK_EQ_EPS(PointOf(8).y, -9);
+    CHECK_EQ_EPS(PointOf(9).x, 3);
+    CHECK_EQ_EPS(PointOf(9).y, -9);
+}
+
+TEST_CASE(redundant) {
+    // The chain, with the symmetric constraint between A and B added twice.
+    // Looking for the constraints to remove redoes the substitution without
+    // each one in turn; that mustn't change the solution written back.
+    CHECK_LOAD("redundant.slvs");
+    MovePoint(9, 1, 1);
+    Group *g = SolveWithSubstitution();
+    CHECK_TRUE(g->solved.how == SolveResult::REDUNDANT_OKAY);
+    CHECK_TRUE(g->solved.remove.n == 2);
+    CHECK_TRUE(g->solved.remove[0].v == 1);
+    CHECK_TRUE(g->solved.remove[1].v == 4);
+    CHECK_EQ_EPS(PointOf(9).x, 3);
+    CHECK_EQ_EPS(PointOf(9).y, -9);
+}
+
+TEST_CASE(contradictory) {
+    // A is horizontal from P, and B is symmetric with A and horizontal from
+    // Q; so A and B are fixed at both y = 5 and y = -5. The constraint that
+    // fixes them second is the one that's reported.
+    CHECK_LOAD("contradictory.slvs");
+    Group *g = SolveWithSubstitution();
+    CHECK_TRUE(g->solved.how == SolveResult::REDUNDANT_DIDNT_CONVERGE);
+    CHECK_TRUE(g->solved.remove.n == 1);
+    CHECK_TRUE(g->solved.remove[0].v == 4);
+}
+
+TEST_CASE(loop) {
+    // A, B and C are coincident in a loop, and A is 5 from P. The last of
+    // the coincident constraints is implied by the other two; it mustn't
+    // leave the point that they share fixed where it started, or the
+    // distance couldn't be met.
+    CHECK_LOAD("loop.slvs");
+    MovePoint(6, 1, 1);
+    MovePoint(7, -1, 1);
+    Group *g = SolveWithSubstitution();
+    CHECK_TRUE(g->solved.how == SolveResult::OKAY);
+    CHECK_TRUE(g->solved.remove.n == 0);
+    CHECK_TRUE(g->profile.solve.substituted == 4);
+    CHECK_TRUE(g->solved.dof == 1);
+
+    Vector p = SK.GetEntity(hRequest{4}.entity(0))->PointGetNum();
+    CHECK_EQ_EPS(PointOf(6).Minus(p).Magnitude(), 5);
+    CHECK_TRUE(PointOf(7).Equals(PointOf(6)));
+    CHECK_TRUE(PointOf(8).Equals(PointOf(6)));
+}
+
+TEST_CASE(loop_dof) {
+    // Without substitution, the rank test counts the same freedom: the shared
+    // point can move on a circle around P.
+    CHECK_LOAD("loop.slvs");
+    Group *g = SolveWithSubstitution();
+    CHECK_TRUE(g->solved.dof == 1);
+    CHECK_TRUE(!IsRemoved(g, 4));
+
+    int rank;
+    CHECK_TRUE(SS.TestRankForGroup(SKETCH, &rank) == SolveResult::REDUNDANT_OKAY);
+    CHECK_TRUE(SS.sys.mat.n - rank == 1);
+}
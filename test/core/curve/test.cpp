@@ -0,0 +1,103 @@
+#include "harness.h"
+
+static SBezier Line(double x0, double y0, double x1, double y1) {
+    return SBezier::From(Vector::From(x0, y0, 0), Vector::From(x1, y1, 0));
+}
+
+TEST_CASE(lines_cross) {
+    SBezier a = Line(0, 0, 2, 2),
+            b = Line(0, 2, 2, 0);
+    std::vector<SBezierInter> inters;
+    a.AllIntersectionsWith(&b, &inters);
+    CHECK_TRUE(inters.size() == 1);
+    CHECK_TRUE(inters[0].p.Equals(Vector::From(1, 1, 0)));
+    CHECK_EQ_EPS(inters[0].ta, 0.5);
+    CHECK_EQ_EPS(inters[0].tb, 0.5);
+}
+
+TEST_CASE(lines_miss) {
+    SBezier a = Line(0, 0, 1, 1),
+            b = Line(2, 0, 3, -1);
+    std::vector<SBezierInter> inters;
+    a.AllIntersectionsWith(&b, &inters);
+    CHECK_TRUE(inters.empty());
+}
+
+TEST_CASE(collinear_lines_overlap) {
+    // There's no single point where these meet, so we return none at all.
+    SBezier a = Line(0, 0, 2, 0),
+            b = Line(1, 0, 3, 0);
+    std::vector<SBezierInter> inters;
+    a.AllIntersectionsWith(&b, &inters);
+    CHECK_TRUE(inters.empty());
+}
+
+TEST_CASE(shared_endpoint) {
+    SBezier a = Line(0, 0, 1, 0),
+            b = Line(1, 0, 1, 1);
+    std::vector<SBezierInter> inters;
+    a.AllIntersectionsWith(&b, &inters);
+    CHECK_TRUE(inters.size() == 1);
+    CHECK_EQ_EPS(inters[0].ta, 1.0);
+    CHECK_EQ_EPS(inters[0].tb, 0.0);
+
+    // But curves that just share an endpoint don't cross there.
+    SPointList spl = {};
+    a.AllIntersectionsWith(&b, &spl);
+    CHECK_TRUE(spl.l.IsEmpty());
+    spl.Clear();
+}
+
+TEST_CASE(cubic_and_line) {
+    SBezier a = SBezier::From(Vector::From(0, 0, 0), Vector::From(0, 2, 0),
+                              Vector::From(2, 2, 0), Vector::From(2, 0, 0)),
+            b = Line(-1, 1, 3, 1);
+    std::vector<SBezierInter> inters;
+    a.AllIntersectionsWith(&b, &inters);
+    CHECK_TRUE(inters.size() == 2);
+    for(const SBezierInter &si : inters) {
+        CHECK_EQ_EPS(si.p.y, 1.0);
+        CHECK_TRUE(a.PointAt(si.ta).Equals(si.p));
+        CHECK_TRUE(b.PointAt(si.tb).Equals(si.p));
+    }
+    CHECK_EQ_EPS(inters[0].p.x + inters[1].p.x, 2.0);
+}
+
+TEST_CASE(index_records_curve) {
+    SBezierList sbl = {};
+    SBezier sb;
+    sb = Line(0, 0, 0, 2);  sbl.l.Add(&sb);
+    sb = Line(5, 0, 5, 2);  sbl.l.Add(&sb);
+    sb = Line(2, 0, 2, 2);  sbl.l.Add(&sb);
+
+    SBezierIndex index = {};
+    index.Build(&sbl);
+    SBezier a = Line(1, 1, 3, 1);
+    std::vector<SBezierInter> inters;
+    index.AllIntersectionsWith(&a, &inters);
+    CHECK_TRUE(inters.size() == 1);
+    CHECK_TRUE(inters[0].b == 2);
+    CHECK_TRUE(inters[0].p.Equals(Vector::From(2, 1, 0)));
+
+    index.Clear();
+    sbl.Clear();
+}
+
+TEST_CASE(list_intersections) {
+    SBezierList sbla = {}, sblb = {};
+    SBezier sb;
+    sb = Line(0, 0, 4, 4);  sbla.l.Add(&sb);
+    sb = Line(0, 4, 4, 0);  sblb.l.Add(&sb);
+    sb = Line(0, 3, 4, 3);  sblb.l.Add(&sb);
+    sb = Line(9, 9, 9, 8);  sblb.l.Add(&sb);
+
+    SPointList spl = {};
+    sbla.AllIntersectionsWith(&sblb, &spl);
+    CHECK_TRUE(spl.l.n == 2);
+    CHECK_TRUE(spl.ContainsPoint(Vector::From(2, 2, 0)));
+    CHECK_TRUE(spl.ContainsPoint(Vector::From(3, 3, 0)));
+
+    spl.Clear();
+    sbla.Clear();
+    sblb.Clear();
+}
@@ -0,0 +1,127 @@
+#include "harness.h"
+
+static SKernelContext ContextWithTolerance(double chordTol, int maxSegments) {
+    SKernelContext ctx = {};
+    ctx.chordTol    = chordTol;
+    ctx.maxSegments = maxSegments;
+    return ctx;
+}
+
+// A loop in the xy plane: a circle of radius r, made of four rational
+// quadratic arcs, or a square of side 2*r, both centered on the origin and
+// counterclockwise, so the normal that goes with them is -z.
+static void MakeLoopSet(SBezierLoopSet *sbls, double r, bool circle) {
+    Vector corner[4] = { Vector::From( r,  0, 0), Vector::From( 0,  r, 0),
+                         Vector::From(-r,  0, 0), Vector::From( 0, -r, 0) };
+    if(!circle) {
+        corner[0] = Vector::From( r,  r, 0); corner[1] = Vector::From(-r,  r, 0);
+        corner[2] = Vector::From(-r, -r, 0); corner[3] = Vector::From( r, -r, 0);
+    }
+
+    SBezierLoop sbl = {};
+    for(int i = 0; i < 4; i++) {
+        Vector a = corner[i], b = corner[(i + 1) % 4];
+        SBezier sb;
+        if(circle) {
+            sb = SBezier::From(a, a.Plus(b), b);
+            sb.weight[1] = sqrt(0.5);
+        } else {
+            sb = SBezier::From(a, b);
+        }
+        sbl.l.Add(&sb);
+    }
+    *sbls = {};
+    sbls->l.Add(&sbl);
+    sbls->normal = Vector::From(0, 0, -1);
+    sbls->point  = Vector::From(0, 0, 0);
+}
+
+static void MakeExtrusion(SShell *sh, double r, bool circle, double z0, double z1) {
+    SBezierLoopSet sbls;
+    MakeLoopSet(&sbls, r, circle);
+    *sh = {};
+    sh->MakeFromExtrusionOf(&sbls, Vector::From(0, 0, z0), Vector::From(0, 0, z1),
+                            RGBi(255, 255, 255));
+    sbls.Clear();
+}
+
+TEST_CASE(scope_nests) {
+    SKernelContext outer = ContextWithTolerance(0.5, 10),
+                   inner = ContextWithTolerance(0.1, 20);
+    {
+        SKernelContextScope outerScope(&outer);
+        CHECK_TRUE(SKernelContext::Current() == &outer);
+        {
+            SKernelContextScope innerScope(&inner);
+            CHECK_TRUE(SKernelContext::Current() == &inner);
+        }
+        CHECK_TRUE(SKernelContext::Current() == &outer);
+    }
+    CHECK_TRUE(SKernelContext::Current() != &outer);
+}
+
+// The triangulation of a cylinder, made and triangulated under a context.
+static int CylinderTriangles(const SKernelContext *ctx) {
+    SKernelContextScope scope(ctx);
+    SShell sh;
+    MakeExtrusion(&sh, 10, /*circle=*/true, 0, 10);
+    SMesh m = {};
+    sh.TriangulateInto(&m);
+    int n = m.l.n;
+    m.Clear();
+    sh.Clear();
+    return n;
+}
+
+TEST_CASE(triangulate_uses_context) {
+    SKernelContext coarse = ContextWithTolerance(1.0,   100),
+                   fine   = ContextWithTolerance(0.001, 100);
+    int nCoarse = CylinderTriangles(&coarse),
+        nFine   = CylinderTriangles(&fine);
+    CHECK_TRUE(nCoarse > 0);
+    CHECK_TRUE(nFine > nCoarse);
+    // Asking for the same tolerance again gets exactly the same mesh, however
+    // the work was shared between threads.
+    CHECK_TRUE(CylinderTriangles(&coarse) == nCoarse);
+}
+
+TEST_CASE(segment_limit_uses_context) {
+    SKernelContext few  = ContextWithTolerance(0.001, 4),
+                   many = ContextWithTolerance(0.001, 100);
+    CHECK_TRUE(CylinderTriangles(&many) > CylinderTriangles(&few));
+}
+
+// A box with a cylindrical hole through it, made under a context; returns
+// the volume of its triangle mesh, or zero if the boolean failed.
+static double BoxWithHoleVolume(const SKernelContext *ctx) {
+    SKernelContextScope scope(ctx);
+    SShell box, cylinder, result = {};
+    MakeExtrusion(&box,      20, /*circle=*/false,  0, 10);
+    MakeExtrusion(&cylinder,  5, /*circle=*/true,  -5, 15);
+    result.MakeFromDifferenceOf(&box, &cylinder);
+
+    double volume = 0;
+    if(!result.booleanFailed) {
+        SMesh m = {};
+        result.TriangulateInto(&m);
+        volume = m.CalculateVolume();
+        m.Clear();
+    }
+    result.Clear();
+    cylinder.Clear();
+    box.Clear();
+    return volume;
+}
+
+TEST_CASE(boolean_uses_context) {
+    SKernelContext coarse = ContextWithTolerance(0.5,   100),
+                   fine   = ContextWithTolerance(0.001, 100);
+    // The hole is polygonal, so its volume is a little less than the exact
+    // one; and the finer the tolerance, the closer it gets.
+    double exact   = 40*40*10 - PI*5*5*10,
+           vCoarse = BoxWithHoleVolume(&coarse),
+           vFine   = BoxWithHoleVolume(&fine);
+    CHECK_TRUE(vCoarse > exact && vCoarse < exact + 100);
+    CHECK_TRUE(vFine > exact && vFine < vCoarse);
+    CHECK_TRUE(vFine - exact < 0.1);
+}
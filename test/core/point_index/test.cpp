@@ -0,0 +1,51 @@
+#include "harness.h"
+
+// The strip of triangles from the solver's tests: requests 4 to 9 are datum
+// points in group 2, with the first at the origin and the second at (10, 0),
+// and each of the rest at distance 10 from the two before it.
+static const hGroup SKETCH = { 2 };
+
+static hEntity PointOf(uint32_t request) {
+    return hRequest{request}.entity(0);
+}
+
+TEST_CASE(near_after_solve) {
+    CHECK_LOAD("../../constraint/blocks/strip.slvs");
+    std::vector<hEntity> near;
+    SK.pointIndex.PointsNear(SKETCH, Vector::From(10, 0, 0), 1, &near);
+    CHECK_TRUE(near.size() == 1);
+    CHECK_TRUE(near[0] == PointOf(5));
+
+    SK.pointIndex.PointsNear(SKETCH, Vector::From(10, 10 * sqrt(3) / 2, 0), 6, &near);
+    CHECK_TRUE(near.size() == 2);
+    CHECK_TRUE(near[0] == PointOf(6));
+    CHECK_TRUE(near[1] == PointOf(7));
+
+    CHECK_TRUE(SK.pointIndex.NearestPoint(SKETCH, Vector::From(6, 8, 0), 5) == PointOf(6));
+    CHECK_TRUE(SK.pointIndex.NearestPoint(SKETCH, Vector::From(30, 30, 0), 5) ==
+               Entity::NO_ENTITY);
+}
+
+TEST_CASE(near_after_force) {
+    CHECK_LOAD("../../constraint/blocks/strip.slvs");
+    Vector before = SK.GetEntity(PointOf(9))->PointGetNum();
+    SK.GetEntity(PointOf(9))->PointForceTo(Vector::From(40, 40, 0));
+
+    // Found where it was forced to, and not where it was indexed.
+    std::vector<hEntity> near;
+    SK.pointIndex.PointsNear(SKETCH, before, 1, &near);
+    CHECK_TRUE(near.empty());
+    CHECK_TRUE(SK.pointIndex.NearestPoint(SKETCH, Vector::From(40, 40, 0), 1) == PointOf(9));
+    CHECK_TRUE(SK.pointIndex.NearestPoint(SKETCH, Vector::From(5, 10 * sqrt(3) / 2, 0), 1) ==
+               PointOf(6));
+    CHECK_TRUE(SK.pointIndex.NearestPoint(Group::HGROUP_REFERENCES,
+                                          Vector::From(40, 40, 0), 1) == Entity::NO_ENTITY);
+
+    // And then where the solver puts it.
+    SS.MarkGroupDirty(SKETCH);
+    SS.GenerateAll(SolveSpaceUI::Generate::ALL);
+    Vector after = SK.GetEntity(PointOf(9))->PointGetNum();
+    CHECK_TRUE(SK.pointIndex.NearestPoint(SKETCH, after, LENGTH_EPS) == PointOf(9));
+    CHECK_TRUE(SK.pointIndex.NearestPoint(SKETCH, Vector::From(40, 40, 0), 1) ==
+               Entity::NO_ENTITY);
+}